@@ -0,0 +1,602 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "pmp/algorithms/bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+#include "pmp/algorithms/distance_point_triangle.h"
+#include "pmp/exceptions.h"
+
+namespace pmp {
+namespace {
+
+// Binned SAH splits are used up to this depth, below it we split at the
+// median. This bounds the tree depth and thereby the traversal stacks.
+constexpr unsigned int max_sah_depth = 32;
+constexpr unsigned int max_depth = max_sah_depth + 32;
+constexpr unsigned int n_bins = 16;
+
+// half the surface area of a box
+Scalar half_area(const Point& min, const Point& max)
+{
+    const Point d = max - min;
+    return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+}
+
+Scalar sqr_distance(const Point& p, const Point& min, const Point& max)
+{
+    Scalar d2(0);
+    for (int i = 0; i < 3; ++i)
+    {
+        const Scalar d = std::max({min[i] - p[i], Scalar(0), p[i] - max[i]});
+        d2 += d * d;
+    }
+    return d2;
+}
+
+bool overlap(const Point& min0, const Point& max0, const Point& min1,
+             const Point& max1)
+{
+    for (int i = 0; i < 3; ++i)
+        if (max0[i] < min1[i] || max1[i] < min0[i])
+            return false;
+    return true;
+}
+
+// Closest point on triangle (a, b, c) to p, see Ericson, Real-Time Collision
+// Detection, Section 5.1.5. Avoids the square roots and divisions of
+// dist_point_triangle() in the inner loop of nearest().
+Point closest_point(const Point& p, const Point& a, const Point& b,
+                    const Point& c)
+{
+    const Point ab = b - a;
+    const Point ac = c - a;
+    const Point ap = p - a;
+    const Scalar d1 = dot(ab, ap);
+    const Scalar d2 = dot(ac, ap);
+    if (d1 <= 0 && d2 <= 0)
+        return a;
+
+    const Point bp = p - b;
+    const Scalar d3 = dot(ab, bp);
+    const Scalar d4 = dot(ac, bp);
+    if (d3 >= 0 && d4 <= d3)
+        return b;
+
+    const Scalar vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0)
+        return a + d1 / (d1 - d3) * ab;
+
+    const Point cp = p - c;
+    const Scalar d5 = dot(ab, cp);
+    const Scalar d6 = dot(ac, cp);
+    if (d6 >= 0 && d5 <= d6)
+        return c;
+
+    const Scalar vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0)
+        return a + d2 / (d2 - d6) * ac;
+
+    const Scalar va = d3 * d6 - d5 * d4;
+    if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+        return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+
+    const Scalar sum = va + vb + vc;
+    if (!(sum > 0))
+    {
+        // degenerate triangle
+        Point nearest;
+        dist_point_triangle(p, a, b, c, nearest);
+        return nearest;
+    }
+    return a + (vb / sum) * ab + (vc / sum) * ac;
+}
+
+// interleave the lower 10 bits of x, y, and z
+uint32_t morton_code(uint32_t x, uint32_t y, uint32_t z)
+{
+    auto spread = [](uint32_t v) {
+        v &= 0x3ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+}
+
+} // namespace
+
+struct BVH::Primitive
+{
+    Point min;
+    Point max;
+    Point center;
+    unsigned int triangle;
+};
+
+BVH::BVH(const SurfaceMesh& mesh, unsigned int max_leaf_size)
+    : BVH(mesh, std::vector<Face>(mesh.faces().begin(), mesh.faces().end()),
+          max_leaf_size)
+{
+}
+
+BVH::BVH(const SurfaceMesh& mesh, const std::vector<Face>& faces,
+         unsigned int max_leaf_size)
+{
+    // fan-triangulate faces
+    triangles_.reserve(faces.size());
+    faces_.reserve(faces.size());
+    std::vector<Point> corners;
+    for (auto f : faces)
+    {
+        corners.clear();
+        for (auto v : mesh.vertices(f))
+            corners.push_back(mesh.position(v));
+        for (size_t i = 1; i + 1 < corners.size(); ++i)
+        {
+            triangles_.push_back({corners[0], corners[i], corners[i + 1]});
+            faces_.push_back(f);
+        }
+    }
+
+    if (triangles_.empty())
+        return;
+
+    std::vector<Primitive> primitives(triangles_.size());
+    for (size_t i = 0; i < triangles_.size(); ++i)
+    {
+        const auto& t = triangles_[i];
+        auto& p = primitives[i];
+        p.min = min(t.p0, min(t.p1, t.p2));
+        p.max = max(t.p0, max(t.p1, t.p2));
+        p.center = Scalar(0.5) * (p.min + p.max);
+        p.triangle = (unsigned int)i;
+    }
+
+    nodes_.reserve(2 * primitives.size() / std::max(max_leaf_size, 1u) + 1);
+    build(primitives, 0, (unsigned int)primitives.size(), 0,
+          std::max(max_leaf_size, 1u));
+    nodes_.shrink_to_fit();
+
+    // store triangles in leaf order
+    std::vector<Triangle> sorted_triangles(triangles_.size());
+    std::vector<Face> sorted_faces(faces_.size());
+    for (size_t i = 0; i < primitives.size(); ++i)
+    {
+        sorted_triangles[i] = triangles_[primitives[i].triangle];
+        sorted_faces[i] = faces_[primitives[i].triangle];
+    }
+    triangles_ = std::move(sorted_triangles);
+    faces_ = std::move(sorted_faces);
+}
+
+void BVH::build(std::vector<Primitive>& primitives, unsigned int begin,
+                unsigned int end, unsigned int depth,
+                unsigned int max_leaf_size)
+{
+    const size_t idx = nodes_.size();
+    nodes_.emplace_back();
+
+    // bounds of primitives and of their centers
+    BoundingBox bounds, centers;
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        bounds += BoundingBox(primitives[i].min, primitives[i].max);
+        centers += primitives[i].center;
+    }
+    nodes_[idx].min = bounds.min();
+    nodes_[idx].max = bounds.max();
+
+    const unsigned int n = end - begin;
+    if (n <= max_leaf_size)
+    {
+        nodes_[idx].offset = begin;
+        nodes_[idx].count = n;
+        return;
+    }
+
+    // axis of largest extent of the centers
+    const Point extent = centers.max() - centers.min();
+    int axis = 0;
+    if (extent[1] > extent[axis])
+        axis = 1;
+    if (extent[2] > extent[axis])
+        axis = 2;
+
+    unsigned int mid = begin + n / 2;
+
+    if (extent[axis] > 0 && depth < max_sah_depth)
+    {
+        // find the binned split plane of minimal SAH cost
+        struct Bin
+        {
+            BoundingBox bounds;
+            unsigned int count{0};
+        };
+
+        Scalar best_cost = std::numeric_limits<Scalar>::max();
+        int best_axis = -1;
+        unsigned int best_bin = 0;
+
+        for (int a = 0; a < 3; ++a)
+        {
+            if (!(extent[a] > 0))
+                continue;
+
+            const Scalar scale = n_bins / extent[a];
+            const Scalar offset = centers.min()[a];
+            auto bin_index = [&](const Primitive& p) {
+                const auto b = (unsigned int)((p.center[a] - offset) * scale);
+                return std::min(b, n_bins - 1);
+            };
+
+            std::array<Bin, n_bins> bins;
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                auto& bin = bins[bin_index(primitives[i])];
+                bin.bounds += BoundingBox(primitives[i].min, primitives[i].max);
+                ++bin.count;
+            }
+
+            // sweep from the right to collect the costs of right halves
+            std::array<Scalar, n_bins> right_cost;
+            BoundingBox right;
+            unsigned int right_count = 0;
+            for (unsigned int b = n_bins - 1; b > 0; --b)
+            {
+                right += bins[b].bounds;
+                right_count += bins[b].count;
+                right_cost[b] =
+                    right_count ? right_count *
+                                      half_area(right.min(), right.max())
+                                : Scalar(0);
+            }
+
+            // sweep from the left and evaluate splits before bin b
+            BoundingBox left;
+            unsigned int left_count = 0;
+            for (unsigned int b = 1; b < n_bins; ++b)
+            {
+                left += bins[b - 1].bounds;
+                left_count += bins[b - 1].count;
+                if (left_count == 0 || left_count == n)
+                    continue;
+                const Scalar cost =
+                    left_count * half_area(left.min(), left.max()) +
+                    right_cost[b];
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_axis = a;
+                    best_bin = b;
+                }
+            }
+        }
+
+        if (best_axis != -1)
+        {
+            const Scalar scale = n_bins / extent[best_axis];
+            const Scalar offset = centers.min()[best_axis];
+            auto it = std::partition(
+                primitives.begin() + begin, primitives.begin() + end,
+                [&](const Primitive& p) {
+                    const auto b = (unsigned int)((p.center[best_axis] -
+                                                   offset) *
+                                                  scale);
+                    return std::min(b, n_bins - 1) < best_bin;
+                });
+            mid = (unsigned int)(it - primitives.begin());
+        }
+    }
+
+    // fall back to a median split
+    if (mid == begin || mid == end || depth >= max_sah_depth ||
+        !(extent[axis] > 0))
+    {
+        mid = begin + n / 2;
+        std::nth_element(primitives.begin() + begin, primitives.begin() + mid,
+                         primitives.begin() + end,
+                         [axis](const Primitive& a, const Primitive& b) {
+                             return a.center[axis] < b.center[axis];
+                         });
+    }
+
+    nodes_[idx].count = 0;
+    build(primitives, begin, mid, depth + 1, max_leaf_size);
+    nodes_[idx].offset = (unsigned int)nodes_.size();
+    build(primitives, mid, end, depth + 1, max_leaf_size);
+}
+
+BVH::NearestNeighbor BVH::nearest(const Point& p) const
+{
+    NearestNeighbor result{std::numeric_limits<Scalar>::max(), Face(), p};
+    nearest(p, result);
+    return result;
+}
+
+void BVH::nearest(const Point& p, NearestNeighbor& result) const
+{
+    if (nodes_.empty())
+        return;
+
+    // a valid initial result bounds the search radius
+    Scalar bound = result.face.is_valid() ? sqrnorm(result.nearest - p)
+                                          : std::numeric_limits<Scalar>::max();
+
+    // stack of nodes to visit, with the squared distance to their boxes
+    std::array<std::pair<unsigned int, Scalar>, max_depth + 1> stack;
+    unsigned int top = 0;
+    unsigned int idx = 0;
+
+    while (true)
+    {
+        const Node& node = nodes_[idx];
+        if (node.count)
+        {
+            for (unsigned int i = node.offset; i < node.offset + node.count;
+                 ++i)
+            {
+                const auto& t = triangles_[i];
+                if (sqr_distance(p, min(t.p0, min(t.p1, t.p2)),
+                                 max(t.p0, max(t.p1, t.p2))) >= bound)
+                    continue;
+                const Point nearest = closest_point(p, t.p0, t.p1, t.p2);
+                const Scalar d2 = sqrnorm(nearest - p);
+                if (d2 < bound)
+                {
+                    result.face = faces_[i];
+                    result.nearest = nearest;
+                    bound = d2;
+                }
+            }
+        }
+        else
+        {
+            // descend into the closer child first
+            unsigned int near = idx + 1;
+            unsigned int far = node.offset;
+            Scalar d_near = sqr_distance(p, nodes_[near].min, nodes_[near].max);
+            Scalar d_far = sqr_distance(p, nodes_[far].min, nodes_[far].max);
+            if (d_far < d_near)
+            {
+                std::swap(near, far);
+                std::swap(d_near, d_far);
+            }
+            if (d_near < bound)
+            {
+                if (d_far < bound)
+                    stack[top++] = {far, d_far};
+                idx = near;
+                continue;
+            }
+        }
+
+        // pop the next node that might still contain a closer point
+        while (top > 0 && stack[top - 1].second >= bound)
+            --top;
+        if (top == 0)
+            break;
+        idx = stack[--top].first;
+    }
+
+    if (result.face.is_valid())
+        result.dist = std::sqrt(bound);
+}
+
+void BVH::closest_points(std::span<const Point> queries,
+                         std::span<Face> faces, std::span<Point> points,
+                         std::span<Scalar> distances) const
+{
+    const size_t n = queries.size();
+    if (faces.size() != n || points.size() != n || distances.size() != n)
+        throw InvalidInputException(
+            "BVH::closest_points: Output sizes do not match query size.");
+
+    // sort queries along a Morton curve within their bounding box
+    BoundingBox bbox;
+    for (const auto& q : queries)
+        bbox += q;
+    const Point extent = bbox.max() - bbox.min();
+    const Scalar scale =
+        1023 / std::max({extent[0], extent[1], extent[2],
+                         std::numeric_limits<Scalar>::min()});
+
+    std::vector<std::pair<uint32_t, unsigned int>> order(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Point q = (queries[i] - bbox.min()) * scale;
+        order[i] = {morton_code((uint32_t)q[0], (uint32_t)q[1],
+                                (uint32_t)q[2]),
+                    (unsigned int)i};
+    }
+    std::ranges::sort(order);
+
+    // Process blocks of consecutive queries, seeding each search with the
+    // result of the previous query in the block.
+    const int block_size = 256;
+    const int n_blocks = int((n + block_size - 1) / block_size);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < n_blocks; ++b)
+    {
+        const size_t end = std::min(n, size_t(b + 1) * block_size);
+        NearestNeighbor result{std::numeric_limits<Scalar>::max(), Face(),
+                               Point(0)};
+        for (size_t j = size_t(b) * block_size; j < end; ++j)
+        {
+            const auto i = order[j].second;
+            nearest(queries[i], result);
+            faces[i] = result.face;
+            points[i] = result.nearest;
+            distances[i] = result.dist;
+        }
+    }
+}
+
+std::optional<BVH::Hit> BVH::intersect(const Point& origin,
+                                       const Point& direction, Scalar tmin,
+                                       Scalar tmax) const
+{
+    if (nodes_.empty())
+        return std::nullopt;
+
+    // Möller-Trumbore ray-triangle intersection, in double precision
+    const dvec3 o(origin);
+    const dvec3 d(direction);
+    auto intersect_triangle = [&](const Triangle& t, double t_max,
+                                  double& t_hit) {
+        const double eps = 1e-12;
+        const dvec3 v0(t.p0);
+        const dvec3 e1 = dvec3(t.p1) - v0;
+        const dvec3 e2 = dvec3(t.p2) - v0;
+        const dvec3 h = cross(d, e2);
+        const double a = dot(e1, h);
+        if (std::fabs(a) < eps)
+            return false;
+        const double f = 1.0 / a;
+        const dvec3 s = o - v0;
+        const double u = f * dot(s, h);
+        if (u < 0.0 || u > 1.0)
+            return false;
+        const dvec3 q = cross(s, e1);
+        const double v = f * dot(d, q);
+        if (v < 0.0 || u + v > 1.0)
+            return false;
+        t_hit = f * dot(e2, q);
+        return t_hit >= tmin && t_hit <= t_max;
+    };
+
+    // slab test, returns the ray parameter where the box is entered
+    const Point inv_dir(Scalar(1) / direction[0], Scalar(1) / direction[1],
+                        Scalar(1) / direction[2]);
+    auto intersect_box = [&](const Node& node, Scalar t_max, Scalar& t_entry) {
+        Scalar t0 = tmin;
+        Scalar t1 = t_max;
+        for (int i = 0; i < 3; ++i)
+        {
+            Scalar t_near = (node.min[i] - origin[i]) * inv_dir[i];
+            Scalar t_far = (node.max[i] - origin[i]) * inv_dir[i];
+            if (t_near > t_far)
+                std::swap(t_near, t_far);
+            t0 = std::max(t0, t_near);
+            t1 = std::min(t1, t_far);
+        }
+        t_entry = t0;
+        return t0 <= t1;
+    };
+
+    std::optional<Hit> hit;
+    double t_best = tmax;
+
+    Scalar t_entry;
+    if (!intersect_box(nodes_[0], tmax, t_entry))
+        return std::nullopt;
+
+    std::array<std::pair<unsigned int, Scalar>, max_depth + 1> stack;
+    unsigned int top = 0;
+    unsigned int idx = 0;
+
+    while (true)
+    {
+        const Node& node = nodes_[idx];
+        if (node.count)
+        {
+            for (unsigned int i = node.offset; i < node.offset + node.count;
+                 ++i)
+            {
+                double t;
+                if (intersect_triangle(triangles_[i], t_best, t))
+                {
+                    t_best = t;
+                    hit = Hit{faces_[i], Scalar(t)};
+                }
+            }
+        }
+        else
+        {
+            // traverse front to back
+            unsigned int near = idx + 1;
+            unsigned int far = node.offset;
+            Scalar t_near, t_far;
+            bool hit_near = intersect_box(nodes_[near], t_best, t_near);
+            bool hit_far = intersect_box(nodes_[far], t_best, t_far);
+            if (hit_near && hit_far && t_far < t_near)
+            {
+                std::swap(near, far);
+                std::swap(t_near, t_far);
+            }
+            else if (!hit_near && hit_far)
+            {
+                std::swap(near, far);
+                std::swap(t_near, t_far);
+                std::swap(hit_near, hit_far);
+            }
+            if (hit_near)
+            {
+                if (hit_far)
+                    stack[top++] = {far, t_far};
+                idx = near;
+                continue;
+            }
+        }
+
+        // pop the next node that might still contain a closer hit
+        while (top > 0 && stack[top - 1].second > t_best)
+            --top;
+        if (top == 0)
+            break;
+        idx = stack[--top].first;
+    }
+
+    return hit;
+}
+
+std::vector<Face> BVH::overlapping_faces(const BoundingBox& box) const
+{
+    std::vector<Face> result;
+    if (nodes_.empty() || box.is_empty())
+        return result;
+
+    std::array<unsigned int, max_depth + 1> stack;
+    unsigned int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = nodes_[stack[--top]];
+        if (!overlap(node.min, node.max, box.min(), box.max()))
+            continue;
+
+        if (node.count)
+        {
+            for (unsigned int i = node.offset; i < node.offset + node.count;
+                 ++i)
+            {
+                const auto& t = triangles_[i];
+                if (overlap(min(t.p0, min(t.p1, t.p2)),
+                            max(t.p0, max(t.p1, t.p2)), box.min(), box.max()))
+                    result.push_back(faces_[i]);
+            }
+        }
+        else
+        {
+            stack[top++] = node.offset;
+            stack[top++] = (unsigned int)(&node - nodes_.data()) + 1;
+        }
+    }
+
+    // polygons may be reported by several of their triangles
+    std::ranges::sort(result);
+    auto [first, last] = std::ranges::unique(result);
+    result.erase(first, last);
+    return result;
+}
+
+} // namespace pmp
@@ -0,0 +1,117 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "pmp/bounding_box.h"
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief Bounding volume hierarchy over the faces of a surface mesh.
+//! \details The hierarchy is built using a binned surface area heuristic and
+//! stored as a flat array of nodes in depth-first order, with the triangles of
+//! each leaf stored contiguously. Polygonal faces are fan-triangulated.
+//! The hierarchy keeps its own copy of the face geometry, i.e., it has to be
+//! rebuilt after the mesh has been modified. All queries are const and can be
+//! issued concurrently from multiple threads.
+//! \ingroup algorithms
+class BVH
+{
+public:
+    //! Result of a closest point query.
+    struct NearestNeighbor
+    {
+        Scalar dist;   //!< distance to the closest point
+        Face face;     //!< face containing the closest point
+        Point nearest; //!< the closest point
+    };
+
+    //! Result of a ray intersection query.
+    struct Hit
+    {
+        Face face; //!< the intersected face
+        Scalar t;  //!< ray parameter of the intersection point
+    };
+
+    //! \brief Build the hierarchy for the faces of \p mesh.
+    //! \param mesh The input mesh.
+    //! \param max_leaf_size The maximum number of triangles per leaf.
+    explicit BVH(const SurfaceMesh& mesh, unsigned int max_leaf_size = 4);
+
+    //! \brief Build the hierarchy for a subset of the faces of \p mesh.
+    //! \param mesh The input mesh.
+    //! \param faces The faces to be stored in the hierarchy.
+    //! \param max_leaf_size The maximum number of triangles per leaf.
+    BVH(const SurfaceMesh& mesh, const std::vector<Face>& faces,
+        unsigned int max_leaf_size = 4);
+
+    //! \brief Find the closest point on the mesh to \p p.
+    //! \details Returns an invalid face and the largest Scalar value as
+    //! distance for a mesh without faces.
+    NearestNeighbor nearest(const Point& p) const;
+
+    //! \brief Find the closest points on the mesh for a batch of queries.
+    //! \details Equivalent to calling nearest() for each query, but faster
+    //! for large batches: Queries are processed in the order of a space
+    //! filling curve, the result of the previous query bounds the search
+    //! for the next one, and batches are processed in parallel if OpenMP is
+    //! available.
+    //! \param queries The query points.
+    //! \param faces The faces containing the closest points.
+    //! \param points The closest points.
+    //! \param distances The distances of the queries to the closest points.
+    //! \throw InvalidInputException if the output sizes differ from the
+    //! number of queries.
+    void closest_points(std::span<const Point> queries, std::span<Face> faces,
+                        std::span<Point> points,
+                        std::span<Scalar> distances) const;
+
+    //! \brief Intersect the ray `origin + t * direction` with the mesh.
+    //! \return The intersection with the smallest `t` in `[tmin, tmax]`, if
+    //! there is one.
+    std::optional<Hit> intersect(
+        const Point& origin, const Point& direction, Scalar tmin = 0,
+        Scalar tmax = std::numeric_limits<Scalar>::max()) const;
+
+    //! \brief Collect the faces overlapping \p box.
+    //! \details The test is conservative: A face is reported if the bounding
+    //! box of one of its triangles overlaps \p box. Each face is reported once.
+    std::vector<Face> overlapping_faces(const BoundingBox& box) const;
+
+private:
+    // Inner nodes store their first child directly behind them and the index
+    // of the second child in offset. Leaves store a range of triangles.
+    struct Node
+    {
+        Point min;
+        Point max;
+        unsigned int offset;
+        unsigned int count; // zero for inner nodes
+    };
+
+    struct Triangle
+    {
+        Point p0, p1, p2;
+    };
+
+    struct Primitive;
+
+    // closest point search, using a valid result as initial upper bound
+    void nearest(const Point& p, NearestNeighbor& result) const;
+
+    void build(std::vector<Primitive>& primitives, unsigned int begin,
+               unsigned int end, unsigned int depth,
+               unsigned int max_leaf_size);
+
+    std::vector<Node> nodes_;
+    std::vector<Triangle> triangles_;
+    std::vector<Face> faces_;
+};
+
+} // namespace pmp
@@ -6,11 +6,50 @@
 #include "pmp/algorithms/normals.h"
 #include "pmp/algorithms/differential_geometry.h"
 #include "pmp/algorithms/laplace.h"
+#include "pmp/algorithms/neighborhood.h"
 
 #include <algorithm>
 #include <numbers>
+#include <optional>
+#include <span>
+#include <string>
 
 namespace pmp {
+namespace {
+
+// Curvature tensor contribution of an edge, i.e., the dihedral angle times
+// the outer product of the edge vector, scaled by half the edge length to
+// match the Voronoi area. Zero for boundary edges.
+// See \cite cohen-steiner_2003_restricted for details.
+template <typename FaceNormal>
+dmat3 edge_tensor(const SurfaceMesh& mesh, Edge e, FaceNormal&& normal)
+{
+    dmat3 tensor(0.0);
+
+    auto h0 = mesh.halfedge(e, 0);
+    auto h1 = mesh.halfedge(e, 1);
+    auto f0 = mesh.face(h0);
+    auto f1 = mesh.face(h1);
+    if (f0.is_valid() && f1.is_valid())
+    {
+        const dvec3 n0 = normal(f0);
+        const dvec3 n1 = normal(f1);
+        dvec3 ev = (dvec3)mesh.position(mesh.to_vertex(h0));
+        ev -= (dvec3)mesh.position(mesh.to_vertex(h1));
+        double l = norm(ev);
+        ev /= l;
+        l *= 0.5; // only consider half of the edge (matching Voronoi area)
+        const double beta = atan2(dot(cross(n0, n1), ev), dot(n0, n1));
+        ev = sqrt(l) * ev;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                tensor(i, j) = beta * ev[i] * ev[j];
+    }
+
+    return tensor;
+}
+
+} // namespace
 
 class CurvatureAnalyzer
 {
@@ -33,6 +72,13 @@ public:
     void analyze_tensor(unsigned int post_smoothing_steps = 0,
                         bool two_ring_neighborhood = false);
 
+    //! compute curvature information for the vertices whose curvature
+    //! depends on the changed vertices or their incident faces, which are
+    //! returned in \p affected. other vertices are not analyzed.
+    void analyze_locally(const std::vector<Vertex>& changed, bool use_tensor,
+                         bool two_ring_neighborhood,
+                         std::vector<Vertex>& affected);
+
     //! return mean curvature
     Scalar mean_curvature(Vertex v) const
     {
@@ -58,8 +104,18 @@ public:
     }
 
 private:
+    // curvatures from the norm of the Laplacian and the angle deficit
+    void laplace_curvature(Vertex v, double laplace_norm, Scalar area);
+
+    // curvatures from the tensor accumulated over the vertex and the given
+    // neighbors
+    template <typename EdgeTensor, typename VertexArea>
+    void tensor_curvature(Vertex v, std::span<const Vertex> neighbors,
+                          EdgeTensor&& edge_tensors, VertexArea&& area);
+
     // determine curvature values on boundary from non-boundary neighbors
     void set_boundary_curvatures();
+    void set_boundary_curvature(Vertex v);
 
     // smooth curvature values
     void smooth_curvatures(unsigned int iterations);
@@ -77,10 +133,6 @@ CurvatureAnalyzer::CurvatureAnalyzer(SurfaceMesh& mesh) : mesh_(mesh)
 
 void CurvatureAnalyzer::analyze(unsigned int post_smoothing_steps)
 {
-    Scalar kmin, kmax, mean, gauss;
-    Scalar area, sum_angles;
-    Point p0, p1, p2;
-
     // compute area-normalized Laplace
     SparseMatrix L;
     laplace_matrix(mesh_, L);
@@ -90,40 +142,16 @@ void CurvatureAnalyzer::analyze(unsigned int post_smoothing_steps)
     coordinates_to_matrix(mesh_, X);
     DenseMatrix LX = L * X;
 
-    // mean curvature as norm of Laplace
-    // Gauss curvatures as angle deficit
-    // min/max from mean/gauss
-    for (auto v : mesh_.vertices())
+    // vertices are independent of each other
+    const int nv = mesh_.vertices_size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < nv; ++i)
     {
-        kmin = kmax = 0.0;
-
-        if (!mesh_.is_isolated(v) && !mesh_.is_boundary(v))
-        {
-            p0 = mesh_.position(v);
-
-            // Voronoi area
-            area = M.diagonal()[v.idx()];
-
-            // angle sum
-            sum_angles = 0.0;
-            for (auto vh : mesh_.halfedges(v))
-            {
-                p1 = mesh_.position(mesh_.to_vertex(vh));
-                p2 = mesh_.position(
-                    mesh_.to_vertex(mesh_.ccw_rotated_halfedge(vh)));
-                sum_angles += angle(p1 - p0, p2 - p0);
-            }
-
-            mean = 0.5 * LX.row(v.idx()).norm() / area;
-            gauss = (2.0 * std::numbers::pi - sum_angles) / area;
-
-            const Scalar s = sqrt(std::max(Scalar(0.0), mean * mean - gauss));
-            kmin = mean - s;
-            kmax = mean + s;
-        }
-
-        min_curvature_[v] = kmin;
-        max_curvature_[v] = kmax;
+        const Vertex v(i);
+        if (!mesh_.is_deleted(v))
+            laplace_curvature(v, LX.row(i).norm(), M.diagonal()[i]);
     }
 
     // boundary vertices: interpolate from interior neighbors
@@ -136,189 +164,339 @@ void CurvatureAnalyzer::analyze(unsigned int post_smoothing_steps)
 void CurvatureAnalyzer::analyze_tensor(unsigned int post_smoothing_steps,
                                        bool two_ring_neighborhood)
 {
-    auto area = mesh_.add_vertex_property<double>("curv:area", 0.0);
     auto normal = mesh_.add_face_property<dvec3>("curv:normal");
-    auto evec = mesh_.add_edge_property<dvec3>("curv:evec", dvec3(0, 0, 0));
-    auto angle = mesh_.add_edge_property<double>("curv:angle", 0.0);
-
-    dvec3 n0, n1, ev;
-    double l, A, beta, a1, a2, a3;
-    dmat3 tensor;
-
-    double eval1, eval2, eval3, kmin, kmax;
-    dvec3 evec1, evec2, evec3;
-
-    std::vector<Vertex> neighborhood;
-    neighborhood.reserve(15);
+    auto tensor = mesh_.add_edge_property<dmat3>("curv:tensor");
 
     // precompute Voronoi area per vertex
     DiagonalMatrix M;
     mass_matrix(mesh_, M);
-    for (auto v : mesh_.vertices())
+
+    // precompute face normals
+    const int nf = mesh_.faces_size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < nf; ++i)
     {
-        area[v] = M.diagonal()[v.idx()];
+        const Face f(i);
+        if (!mesh_.is_deleted(f))
+            normal[f] = (dvec3)face_normal(mesh_, f);
     }
 
-    // precompute face normals
-    for (auto f : mesh_.faces())
+    // precompute the tensor of each edge once, instead of once per vertex
+    // of its neighborhoods
+    const int ne = mesh_.edges_size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < ne; ++i)
     {
-        normal[f] = (dvec3)face_normal(mesh_, f);
+        const Edge e(i);
+        if (!mesh_.is_deleted(e))
+            tensor[e] =
+                edge_tensor(mesh_, e, [&](Face f) { return normal[f]; });
     }
 
-    // precompute dihedralAngle*edge_length*edge per edge
-    for (auto e : mesh_.edges())
+    // the two-ring tensor accumulates the tensors of the one-ring neighbors
+    std::optional<NeighborhoodIndex> one_ring;
+    if (two_ring_neighborhood)
+        one_ring.emplace(mesh_);
+
+    // compute curvature tensor for each vertex
+    const int nv = mesh_.vertices_size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < nv; ++i)
+    {
+        const Vertex v(i);
+        if (mesh_.is_deleted(v))
+            continue;
+        tensor_curvature(
+            v, one_ring ? one_ring->neighbors(v) : std::span<const Vertex>{},
+            [&](Edge e) { return tensor[e]; },
+            [&](Vertex vv) { return M.diagonal()[vv.idx()]; });
+    }
+
+    // clean-up properties
+    mesh_.remove_edge_property(tensor);
+    mesh_.remove_face_property(normal);
+
+    // boundary vertices: interpolate from interior neighbors
+    set_boundary_curvatures();
+
+    // smooth curvature values
+    smooth_curvatures(post_smoothing_steps);
+}
+
+void CurvatureAnalyzer::analyze_locally(const std::vector<Vertex>& changed,
+                                        bool use_tensor,
+                                        bool two_ring_neighborhood,
+                                        std::vector<Vertex>& affected)
+{
+    // marks of vertices collected in affected and in analyzed
+    enum : unsigned char
     {
-        auto h0 = mesh_.halfedge(e, 0);
-        auto h1 = mesh_.halfedge(e, 1);
-        auto f0 = mesh_.face(h0);
-        auto f1 = mesh_.face(h1);
-        if (f0.is_valid() && f1.is_valid())
+        Affected = 1,
+        Analyzed = 2
+    };
+    std::vector<unsigned char> marks(mesh_.vertices_size(), 0);
+
+    affected.clear();
+    auto add_affected = [&](Vertex v) {
+        if (!(marks[v.idx()] & Affected))
         {
-            n0 = normal[f0];
-            n1 = normal[f1];
-            ev = (dvec3)mesh_.position(mesh_.to_vertex(h0));
-            ev -= (dvec3)mesh_.position(mesh_.to_vertex(h1));
-            l = norm(ev);
-            ev /= l;
-            l *= 0.5; // only consider half of the edge (matching Voronoi area)
-            angle[e] = atan2(dot(cross(n0, n1), ev), dot(n0, n1));
-            evec[e] = sqrt(l) * ev;
+            marks[v.idx()] |= Affected;
+            affected.push_back(v);
         }
+    };
+
+    // the Laplacian, the angle sum, and the edge tensors of a vertex depend
+    // on its incident faces and the positions of their vertices
+    for (auto v : changed)
+    {
+        if (mesh_.is_deleted(v))
+            continue;
+        add_affected(v);
+        for (auto f : mesh_.faces(v))
+            for (auto vv : mesh_.vertices(f))
+                add_affected(vv);
     }
 
-    // compute curvature tensor for each vertex
-    for (auto v : mesh_.vertices())
+    // the two-ring tensor accumulates the one-ring tensors of the neighbors
+    if (use_tensor && two_ring_neighborhood)
+    {
+        const size_t n = affected.size();
+        for (size_t i = 0; i < n; ++i)
+            for (auto vv : mesh_.vertices(affected[i]))
+                add_affected(vv);
+    }
+
+    // boundary vertices interpolate their interior neighbors
+    const size_t n = affected.size();
+    for (size_t i = 0; i < n; ++i)
+        if (!mesh_.is_boundary(affected[i]))
+            for (auto vv : mesh_.vertices(affected[i]))
+                if (mesh_.is_boundary(vv))
+                    add_affected(vv);
+
+    // analyze the interior affected vertices and all interior neighbors of
+    // the boundary ones
+    std::vector<Vertex> analyzed;
+    auto add_analyzed = [&](Vertex v) {
+        if (!mesh_.is_boundary(v) && !(marks[v.idx()] & Analyzed))
+        {
+            marks[v.idx()] |= Analyzed;
+            analyzed.push_back(v);
+        }
+    };
+    for (auto v : affected)
     {
-        kmin = 0.0;
-        kmax = 0.0;
+        add_analyzed(v);
+        if (mesh_.is_boundary(v))
+            for (auto vv : mesh_.vertices(v))
+                add_analyzed(vv);
+    }
 
-        if (!mesh_.is_isolated(v) && !mesh_.is_boundary(v))
+    const int na = analyzed.size();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<Vertex> neighbors;
+        dvec3 laplace;
+        double area;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (int i = 0; i < na; ++i)
         {
-            // one-ring or two-ring neighborhood?
-            neighborhood.clear();
-            neighborhood.push_back(v);
-            if (two_ring_neighborhood)
+            const Vertex v = analyzed[i];
+            if (use_tensor)
+            {
+                neighbors.clear();
+                if (two_ring_neighborhood)
+                    for (auto vv : mesh_.vertices(v))
+                        neighbors.push_back(vv);
+                tensor_curvature(
+                    v, neighbors,
+                    [&](Edge e) {
+                        return edge_tensor(mesh_, e, [&](Face f) {
+                            return (dvec3)face_normal(mesh_, f);
+                        });
+                    },
+                    [&](Vertex vv) {
+                        vertex_laplace(mesh_, vv, laplace, area);
+                        return area;
+                    });
+            }
+            else
             {
-                for (auto vv : mesh_.vertices(v))
-                    neighborhood.push_back(vv);
+                vertex_laplace(mesh_, v, laplace, area);
+                laplace_curvature(v, norm(laplace), area);
             }
+        }
+    }
 
-            A = 0.0;
-            tensor = dmat3(0.0);
+    // boundary vertices: interpolate from interior neighbors
+    for (auto v : affected)
+        if (mesh_.is_boundary(v))
+            set_boundary_curvature(v);
+}
 
-            // compute tensor over vertex neighborhood stored in vertices
-            for (auto nit : neighborhood)
-            {
-                if (mesh_.is_boundary(nit))
-                    continue;
+void CurvatureAnalyzer::laplace_curvature(Vertex v, double laplace_norm,
+                                          Scalar area)
+{
+    Scalar kmin(0.0), kmax(0.0);
 
-                // accumulate tensor from dihedral angles around vertices
-                for (auto e : mesh_.edges(nit))
-                {
-                    ev = evec[e];
-                    beta = angle[e];
-                    for (int i = 0; i < 3; ++i)
-                        for (int j = 0; j < 3; ++j)
-                            tensor(i, j) += beta * ev[i] * ev[j];
-                }
+    // mean curvature as norm of Laplace
+    // Gauss curvatures as angle deficit
+    // min/max from mean/gauss
+    if (!mesh_.is_isolated(v) && !mesh_.is_boundary(v))
+    {
+        const Point p0 = mesh_.position(v);
 
-                // accumulate area
-                A += area[nit];
-            }
+        // angle sum
+        Scalar sum_angles(0.0);
+        for (auto vh : mesh_.halfedges(v))
+        {
+            const Point p1 = mesh_.position(mesh_.to_vertex(vh));
+            const Point p2 = mesh_.position(
+                mesh_.to_vertex(mesh_.ccw_rotated_halfedge(vh)));
+            sum_angles += angle(p1 - p0, p2 - p0);
+        }
+
+        const Scalar mean = 0.5 * laplace_norm / area;
+        const Scalar gauss = (2.0 * std::numbers::pi - sum_angles) / area;
+
+        const Scalar s = sqrt(std::max(Scalar(0.0), mean * mean - gauss));
+        kmin = mean - s;
+        kmax = mean + s;
+    }
 
-            // normalize tensor by accumulated
-            tensor /= A;
+    min_curvature_[v] = kmin;
+    max_curvature_[v] = kmax;
+}
 
-            // Eigen-decomposition
-            const bool ok = symmetric_eigendecomposition(
-                tensor, eval1, eval2, eval3, evec1, evec2, evec3);
-            if (ok)
+template <typename EdgeTensor, typename VertexArea>
+void CurvatureAnalyzer::tensor_curvature(Vertex v,
+                                         std::span<const Vertex> neighbors,
+                                         EdgeTensor&& edge_tensors,
+                                         VertexArea&& area)
+{
+    double kmin(0.0), kmax(0.0);
+
+    if (!mesh_.is_isolated(v) && !mesh_.is_boundary(v))
+    {
+        double A(0.0);
+        dmat3 tensor(0.0);
+
+        // accumulate tensor from dihedral angles around vertices
+        auto accumulate = [&](Vertex nit) {
+            if (mesh_.is_boundary(nit))
+                return;
+            for (auto e : mesh_.edges(nit))
+                tensor += edge_tensors(e);
+            A += area(nit);
+        };
+
+        // compute tensor over the vertex and its neighbors
+        accumulate(v);
+        for (auto nit : neighbors)
+            accumulate(nit);
+
+        // normalize tensor by accumulated
+        tensor /= A;
+
+        // Eigen-decomposition
+        double eval1, eval2, eval3;
+        dvec3 evec1, evec2, evec3;
+        const bool ok = symmetric_eigendecomposition(
+            tensor, eval1, eval2, eval3, evec1, evec2, evec3);
+        if (ok)
+        {
+            // curvature values:
+            //   normal vector -> eval with smallest absolute value
+            //   evals are sorted in decreasing order
+            const double a1 = fabs(eval1);
+            const double a2 = fabs(eval2);
+            const double a3 = fabs(eval3);
+            if (a1 < a2)
             {
-                // curvature values:
-                //   normal vector -> eval with smallest absolute value
-                //   evals are sorted in decreasing order
-                a1 = fabs(eval1);
-                a2 = fabs(eval2);
-                a3 = fabs(eval3);
-                if (a1 < a2)
+                if (a1 < a3)
                 {
-                    if (a1 < a3)
-                    {
-                        // e1 is normal
-                        kmax = eval2;
-                        kmin = eval3;
-                    }
-                    else
-                    {
-                        // e3 is normal
-                        kmax = eval1;
-                        kmin = eval2;
-                    }
+                    // e1 is normal
+                    kmax = eval2;
+                    kmin = eval3;
                 }
                 else
                 {
-                    if (a2 < a3)
-                    {
-                        // e2 is normal
-                        kmax = eval1;
-                        kmin = eval3;
-                    }
-                    else
-                    {
-                        // e3 is normal
-                        kmax = eval1;
-                        kmin = eval2;
-                    }
+                    // e3 is normal
+                    kmax = eval1;
+                    kmin = eval2;
+                }
+            }
+            else
+            {
+                if (a2 < a3)
+                {
+                    // e2 is normal
+                    kmax = eval1;
+                    kmin = eval3;
+                }
+                else
+                {
+                    // e3 is normal
+                    kmax = eval1;
+                    kmin = eval2;
                 }
             }
         }
-
-        assert(kmin <= kmax);
-
-        min_curvature_[v] = kmin;
-        max_curvature_[v] = kmax;
     }
 
-    // clean-up properties
-    mesh_.remove_vertex_property(area);
-    mesh_.remove_edge_property(evec);
-    mesh_.remove_edge_property(angle);
-    mesh_.remove_face_property(normal);
-
-    // boundary vertices: interpolate from interior neighbors
-    set_boundary_curvatures();
+    assert(kmin <= kmax);
 
-    // smooth curvature values
-    smooth_curvatures(post_smoothing_steps);
+    min_curvature_[v] = kmin;
+    max_curvature_[v] = kmax;
 }
 
 void CurvatureAnalyzer::set_boundary_curvatures()
 {
-    for (auto v : mesh_.vertices())
+    // boundary vertices only read interior ones
+    const int nv = mesh_.vertices_size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < nv; ++i)
     {
-        if (mesh_.is_boundary(v))
-        {
-            Scalar kmin(0.0), kmax(0.0), sum(0.0);
-            for (auto vv : mesh_.vertices(v))
-            {
-                if (!mesh_.is_boundary(vv))
-                {
-                    sum += 1.0;
-                    kmin += min_curvature_[vv];
-                    kmax += max_curvature_[vv];
-                }
-            }
-
-            if (sum)
-            {
-                kmin /= sum;
-                kmax /= sum;
-            }
+        const Vertex v(i);
+        if (!mesh_.is_deleted(v) && mesh_.is_boundary(v))
+            set_boundary_curvature(v);
+    }
+}
 
-            min_curvature_[v] = kmin;
-            max_curvature_[v] = kmax;
+void CurvatureAnalyzer::set_boundary_curvature(Vertex v)
+{
+    Scalar kmin(0.0), kmax(0.0), sum(0.0);
+    for (auto vv : mesh_.vertices(v))
+    {
+        if (!mesh_.is_boundary(vv))
+        {
+            sum += 1.0;
+            kmin += min_curvature_[vv];
+            kmax += max_curvature_[vv];
         }
     }
+
+    if (sum)
+    {
+        kmin /= sum;
+        kmax /= sum;
+    }
+
+    min_curvature_[v] = kmin;
+    max_curvature_[v] = kmax;
 }
 
 void CurvatureAnalyzer::smooth_curvatures(unsigned int iterations)
@@ -399,46 +577,44 @@ void curvature_to_texture_coordinates(SurfaceMesh& mesh)
     }
 }
 
-void curvature(SurfaceMesh& mesh, Curvature c, int smoothing_steps,
-               bool use_tensor, bool use_two_ring)
-{
-    CurvatureAnalyzer analyzer(mesh);
-    if (use_tensor)
-        analyzer.analyze_tensor(smoothing_steps, use_two_ring);
-    else
-        analyzer.analyze(smoothing_steps);
+namespace {
 
+// store the curvature of type c of the given vertices in "v:curv"
+template <typename Vertices>
+void store_curvature(SurfaceMesh& mesh, const CurvatureAnalyzer& analyzer,
+                     Curvature c, const Vertices& vertices)
+{
     auto curvatures = mesh.vertex_property<Scalar>("v:curv");
 
     switch (c)
     {
         case Curvature::Min:
         {
-            for (auto v : mesh.vertices())
+            for (auto v : vertices)
                 curvatures[v] = analyzer.min_curvature(v);
             break;
         }
         case Curvature::Max:
         {
-            for (auto v : mesh.vertices())
+            for (auto v : vertices)
                 curvatures[v] = analyzer.max_curvature(v);
             break;
         }
         case Curvature::Mean:
         {
-            for (auto v : mesh.vertices())
+            for (auto v : vertices)
                 curvatures[v] = analyzer.mean_curvature(v);
             break;
         }
         case Curvature::Gauss:
         {
-            for (auto v : mesh.vertices())
+            for (auto v : vertices)
                 curvatures[v] = analyzer.gauss_curvature(v);
             break;
         }
         case Curvature::MaxAbs:
         {
-            for (auto v : mesh.vertices())
+            for (auto v : vertices)
                 curvatures[v] = analyzer.max_abs_curvature(v);
             break;
         }
@@ -447,4 +623,36 @@ void curvature(SurfaceMesh& mesh, Curvature c, int smoothing_steps,
     }
 }
 
+} // namespace
+
+void curvature(SurfaceMesh& mesh, Curvature c, int smoothing_steps,
+               bool use_tensor, bool use_two_ring)
+{
+    CurvatureAnalyzer analyzer(mesh);
+    if (use_tensor)
+        analyzer.analyze_tensor(smoothing_steps, use_two_ring);
+    else
+        analyzer.analyze(smoothing_steps);
+
+    store_curvature(mesh, analyzer, c, mesh.vertices());
+}
+
+void update_curvature(SurfaceMesh& mesh,
+                      const std::vector<Vertex>& changed_vertices,
+                      Curvature c, bool use_tensor, bool use_two_ring)
+{
+    if (!mesh.has_vertex_property("v:curv"))
+    {
+        auto what = std::string{__func__} + ": Missing curvature values.";
+        throw InvalidInputException(what);
+    }
+
+    CurvatureAnalyzer analyzer(mesh);
+    std::vector<Vertex> affected;
+    analyzer.analyze_locally(changed_vertices, use_tensor, use_two_ring,
+                             affected);
+
+    store_curvature(mesh, analyzer, c, affected);
+}
+
 } // namespace pmp
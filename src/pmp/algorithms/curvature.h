@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "pmp/surface_mesh.h"
 
 namespace pmp {
@@ -20,7 +22,8 @@ enum class Curvature
 
 //! \brief Compute per-vertex curvature (min,max,mean,Gaussian).
 //! \details Curvature values for boundary vertices are interpolated from their
-//! interior neighbors. Curvature values can be smoothed. See
+//! interior neighbors. Curvature values can be smoothed. The vertices are
+//! processed in parallel if OpenMP is available. See
 //! \cite meyer_2003_discrete and \cite cohen-steiner_2003_restricted for
 //! details.
 //! \note This algorithm works on general polygon meshes.
@@ -29,6 +32,33 @@ void curvature(SurfaceMesh& mesh, Curvature c = Curvature::Mean,
                int smoothing_steps = 0, bool use_tensor = false,
                bool use_two_ring = false);
 
+//! \brief Update the curvature values after local changes of the mesh.
+//! \details Recomputes the curvature values "v:curv" only for the vertices
+//! whose neighborhoods contain one of the changed vertices, including
+//! boundary vertices interpolating them. The curvature computations are
+//! local to these neighborhoods, only the bookkeeping of temporary per-vertex
+//! values and marks is linear in the number of vertices. The result matches
+//! a subsequent call of curvature() with the same parameters, up to
+//! round-off. The connectivity may have changed locally, e.g., by edge flips
+//! or splits, as long as the changed vertices include all new vertices and
+//! all vertices of new or modified faces.
+//! \param mesh The mesh, with curvature values computed by curvature().
+//! \param changed_vertices The vertices that were added, moved, or are
+//! incident to faces that were added or modified since the curvature values
+//! were computed. Deleted vertices are skipped.
+//! \param c The type of curvature, as passed to curvature().
+//! \param use_tensor As passed to curvature().
+//! \param use_two_ring As passed to curvature().
+//! \pre curvature() has been called without smoothing steps, which affect
+//! all vertices.
+//! \throw InvalidInputException if the mesh has no curvature values.
+//! \note This algorithm works on general polygon meshes.
+//! \ingroup algorithms
+void update_curvature(SurfaceMesh& mesh,
+                      const std::vector<Vertex>& changed_vertices,
+                      Curvature c = Curvature::Mean, bool use_tensor = false,
+                      bool use_two_ring = false);
+
 //! convert curvature values "v:curv" to 1D texture coordinates stored in vertex property "v:tex"
 void curvature_to_texture_coordinates(SurfaceMesh& mesh);
 
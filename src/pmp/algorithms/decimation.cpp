@@ -3,211 +3,19 @@
 
 #include "pmp/algorithms/decimation.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <limits>
 #include <numbers>
 
 #include "pmp/algorithms/distance_point_triangle.h"
+#include "pmp/algorithms/heap.h"
 #include "pmp/algorithms/normals.h"
 
 namespace pmp {
 namespace {
 
-template <class HeapEntry, class HeapInterface>
-class Heap : private std::vector<HeapEntry>
-{
-public:
-    using This = Heap<HeapEntry, HeapInterface>;
-
-    // Constructor
-    Heap() : HeapVector() {}
-
-    // Construct with a given \p HeapInterface.
-    Heap(const HeapInterface& i) : HeapVector(), interface_(i) {}
-
-    // Destructor.
-    ~Heap() = default;
-
-    // clear the heap
-    void clear() { HeapVector::clear(); }
-
-    // is heap empty?
-    bool empty() { return HeapVector::empty(); }
-
-    // returns the size of heap
-    unsigned int size() { return (unsigned int)HeapVector::size(); }
-
-    // reserve space for N entries
-    void reserve(unsigned int n) { HeapVector::reserve(n); }
-
-    // reset heap position to -1 (not in heap)
-    void reset_heap_position(HeapEntry h)
-    {
-        interface_.set_heap_position(h, -1);
-    }
-
-    // is an entry in the heap?
-    bool is_stored(HeapEntry h)
-    {
-        return interface_.get_heap_position(h) != -1;
-    }
-
-    // insert the entry h
-    void insert(HeapEntry h)
-    {
-        This::push_back(h);
-        upheap(size() - 1);
-    }
-
-    // get the first entry
-    HeapEntry front()
-    {
-        assert(!empty());
-        return entry(0);
-    }
-
-    // delete the first entry
-    void pop_front()
-    {
-        assert(!empty());
-        interface_.set_heap_position(entry(0), -1);
-        if (size() > 1)
-        {
-            entry(0, entry(size() - 1));
-            HeapVector::resize(size() - 1);
-            downheap(0);
-        }
-        else
-            HeapVector::resize(size() - 1);
-    }
-
-    // remove an entry
-    void remove(HeapEntry h)
-    {
-        const int pos = interface_.get_heap_position(h);
-        interface_.set_heap_position(h, -1);
-
-        assert(pos != -1);
-        assert((unsigned int)pos < size());
-
-        // last item ?
-        if ((unsigned int)pos == size() - 1)
-            HeapVector::resize(size() - 1);
-
-        else
-        {
-            entry(pos, entry(size() - 1)); // move last elem to pos
-            HeapVector::resize(size() - 1);
-            downheap(pos);
-            upheap(pos);
-        }
-    }
-
-    // update an entry: change the key and update the position to
-    // reestablish the heap property.
-    void update(HeapEntry h)
-    {
-        const int pos = interface_.get_heap_position(h);
-        assert(pos != -1);
-        assert((unsigned int)pos < size());
-        downheap(pos);
-        upheap(pos);
-    }
-
-    // Check heap condition. true if heap condition is satisfied, false if not.
-    bool check()
-    {
-        bool ok(true);
-        unsigned int i, j;
-        for (i = 0; i < size(); ++i)
-        {
-            if (((j = left(i)) < size()) &&
-                interface_.greater(entry(i), entry(j)))
-            {
-                ok = false;
-            }
-            if (((j = right(i)) < size()) &&
-                interface_.greater(entry(i), entry(j)))
-            {
-                ok = false;
-            }
-        }
-        return ok;
-    }
-
-private:
-    using HeapVector = std::vector<HeapEntry>;
-
-    // Upheap. Establish heap property.
-    void upheap(unsigned int idx)
-    {
-        HeapEntry h = entry(idx);
-        unsigned int parent_idx;
-
-        while ((idx > 0) && interface_.less(h, entry(parent_idx = parent(idx))))
-        {
-            entry(idx, entry(parent_idx));
-            idx = parent_idx;
-        }
-
-        entry(idx, h);
-    }
-
-    // Downheap. Establish heap property.
-    void downheap(unsigned int idx)
-    {
-        HeapEntry h = entry(idx);
-        unsigned int child_idx;
-        const unsigned int s = size();
-
-        while (idx < s)
-        {
-            child_idx = left(idx);
-            if (child_idx >= s)
-                break;
-
-            if ((child_idx + 1 < s) &&
-                (interface_.less(entry(child_idx + 1), entry(child_idx))))
-                ++child_idx;
-
-            if (interface_.less(h, entry(child_idx)))
-                break;
-
-            entry(idx, entry(child_idx));
-            idx = child_idx;
-        }
-
-        entry(idx, h);
-    }
-
-    // Get the entry at index idx
-    inline HeapEntry entry(unsigned int idx)
-    {
-        assert(idx < size());
-        return (This::operator[](idx));
-    }
-
-    // Set entry H to index idx and update H's heap position.
-    inline void entry(unsigned int idx, HeapEntry h)
-    {
-        assert(idx < size());
-        This::operator[](idx) = h;
-        interface_.set_heap_position(h, idx);
-    }
-
-    // Get parent's index
-    inline unsigned int parent(unsigned int i) { return (i - 1) >> 1; }
-
-    // Get left child's index
-    inline unsigned int left(unsigned int i) { return (i << 1) + 1; }
-
-    // Get right child's index
-    inline unsigned int right(unsigned int i) { return (i << 1) + 2; }
-
-    // Instance of HeapInterface
-    HeapInterface interface_;
-};
-
 // Store a quadric as a symmetric 4x4 matrix.
 class Quadric
 {
@@ -406,6 +214,26 @@ private:
 
     using Points = std::vector<Point>;
 
+    // Triangle corners and conservative bounding sphere used to speed up
+    // the point-to-triangle distance queries of the Hausdorff error check
+    struct Triangle
+    {
+        Triangle(Face f, const Point& a, const Point& b, const Point& c);
+
+        // lower bound for the distance of p to the triangle
+        Scalar min_distance(const Point& p) const
+        {
+            return distance(p, center) - radius;
+        }
+
+        Face face;
+        Point p0, p1, p2;
+        Point center;
+        Scalar radius;
+    };
+
+    using Triangles = std::vector<Triangle>;
+
     // put the vertex v in the priority queue
     void enqueue_vertex(PriorityQueue& queue, Vertex v);
 
@@ -427,8 +255,17 @@ private:
     // compute aspect ratio for face f
     Scalar aspect_ratio(Face f) const;
 
-    // compute distance from point p to triangle f
-    Scalar distance(Face f, const Point& p) const;
+    // collect the triangles incident to v, skipping faces f0 and f1
+    void collect_triangles(Vertex v, Face f0, Face f1, Triangles& triangles);
+
+    // is point p within hausdorff_error_ of one of the triangles?
+    // the optional triangle \p first is tested before all others.
+    bool is_within_error(const Point& p, const Triangles& triangles,
+                         const Triangle* first = nullptr) const;
+
+    // face of the triangle closest to point p, distance returned in dist
+    Face closest_triangle(const Point& p, const Triangles& triangles,
+                          Scalar& dist) const;
 
     SurfaceMesh& mesh_;
 
@@ -440,6 +277,7 @@ private:
     VertexProperty<Quadric> vquadric_;
     FaceProperty<NormalCone> normal_cone_;
     FaceProperty<Points> face_points_;
+    FaceProperty<Scalar> face_error_;
 
     VertexProperty<Point> vpoint_;
     FaceProperty<Point> fnormal_;
@@ -457,6 +295,10 @@ private:
     Scalar seam_threshold_;
     Scalar seam_angle_deviation_;
     unsigned int max_valence_;
+
+    // scratch buffers for the Hausdorff error computations
+    Triangles triangles_;
+    Points points_;
 };
 
 Decimation::Decimation(SurfaceMesh& mesh) : mesh_(mesh)
@@ -491,6 +333,7 @@ Decimation::~Decimation()
     mesh_.remove_vertex_property(vquadric_);
     mesh_.remove_face_property(normal_cone_);
     mesh_.remove_face_property(face_points_);
+    mesh_.remove_face_property(face_error_);
     mesh_.remove_edge_property(texture_seams_);
 }
 
@@ -514,9 +357,15 @@ void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
     else
         mesh_.remove_face_property(normal_cone_);
     if (hausdorff_error > 0.0)
+    {
         face_points_ = mesh_.face_property<Points>("f:points");
+        face_error_ = mesh_.face_property<Scalar>("f:error");
+    }
     else
+    {
         mesh_.remove_face_property(face_points_);
+        mesh_.remove_face_property(face_error_);
+    }
 
     // vertex selection
     has_selection_ = false;
@@ -578,6 +427,7 @@ void Decimation::initialize(Scalar aspect_ratio, Scalar edge_length,
         for (auto f : mesh_.faces())
         {
             Points().swap(face_points_[f]); // free mem
+            face_error_[f] = 0.0;
         }
     }
 
@@ -684,17 +534,16 @@ void Decimation::enqueue_vertex(PriorityQueue& queue, Vertex v)
     float prio, min_prio(std::numeric_limits<float>::max());
     Halfedge min_h;
 
+    // the priority is cheap to evaluate, so only run the (potentially
+    // expensive) legality checks for collapses that would improve the target
     for (auto h : mesh_.halfedges(v))
     {
         const CollapseData cd(mesh_, h);
-        if (is_collapse_legal(cd))
+        prio = priority(cd);
+        if (prio != -1.0 && prio < min_prio && is_collapse_legal(cd))
         {
-            prio = priority(cd);
-            if (prio != -1.0 && prio < min_prio)
-            {
-                min_prio = prio;
-                min_h = h;
-            }
+            min_prio = prio;
+            min_h = h;
         }
     }
 
@@ -873,42 +722,43 @@ bool Decimation::is_collapse_legal(const CollapseData& cd)
     // check Hausdorff error
     if (hausdorff_error_)
     {
-        Points points;
-        bool ok;
+        // triangles after the collapse
+        vpoint_[cd.v0] = p1;
+        collect_triangles(cd.v0, cd.fl, cd.fr, triangles_);
+        vpoint_[cd.v0] = p0;
 
-        // collect points to be tested
-        for (auto f : mesh_.faces(cd.v0))
-        {
-            std::copy(face_points_[f].begin(), face_points_[f].end(),
-                      std::back_inserter(points));
-        }
-        points.push_back(vpoint_[cd.v0]);
+        // test the removed vertex
+        if (!is_within_error(p0, triangles_))
+            return false;
 
-        // test points against all faces
-        vpoint_[cd.v0] = p1;
-        for (auto point : points)
+        // moving v0 to p1 moves every point of a remaining face by at most
+        // |p1-p0|. if this does not exceed the error bound of the face, all
+        // its points are fine. otherwise test them, starting with their face.
+        const Scalar displacement = distance(p0, p1);
+        for (const auto& t : triangles_)
         {
-            ok = false;
+            if (face_error_[t.face] + displacement < hausdorff_error_)
+                continue;
 
-            for (auto f : mesh_.faces(cd.v0))
+            for (const auto& point : face_points_[t.face])
             {
-                if (f != cd.fl && f != cd.fr)
-                {
-                    if (distance(f, point) < hausdorff_error_)
-                    {
-                        ok = true;
-                        break;
-                    }
-                }
+                if (!is_within_error(point, triangles_, &t))
+                    return false;
             }
+        }
 
-            if (!ok)
+        // points of the two removed faces
+        for (auto f : {cd.fl, cd.fr})
+        {
+            if (!f.is_valid())
+                continue;
+
+            for (const auto& point : face_points_[f])
             {
-                vpoint_[cd.v0] = p0;
-                return false;
+                if (!is_within_error(point, triangles_))
+                    return false;
             }
         }
-        vpoint_[cd.v0] = p0;
     }
 
     // collapse passed all tests -> ok
@@ -1096,54 +946,40 @@ void Decimation::postprocess_collapse(const CollapseData& cd)
     // update Hausdorff error
     if (hausdorff_error_)
     {
-        Points points;
-
         // collect points to be distributed
+        points_.clear();
 
         // points of v1's one-ring
         for (auto f : mesh_.faces(cd.v1))
         {
-            std::copy(face_points_[f].begin(), face_points_[f].end(),
-                      std::back_inserter(points));
+            std::ranges::copy(face_points_[f], std::back_inserter(points_));
             face_points_[f].clear();
+            face_error_[f] = 0.0;
         }
 
         // points of the 2 removed triangles
         if (cd.fl.is_valid())
         {
-            std::copy(face_points_[cd.fl].begin(), face_points_[cd.fl].end(),
-                      std::back_inserter(points));
+            std::ranges::copy(face_points_[cd.fl], std::back_inserter(points_));
             Points().swap(face_points_[cd.fl]); // free mem
         }
         if (cd.fr.is_valid())
         {
-            std::copy(face_points_[cd.fr].begin(), face_points_[cd.fr].end(),
-                      std::back_inserter(points));
+            std::ranges::copy(face_points_[cd.fr], std::back_inserter(points_));
             Points().swap(face_points_[cd.fr]); // free mem
         }
 
         // the removed vertex
-        points.push_back(vpoint_[cd.v0]);
+        points_.push_back(vpoint_[cd.v0]);
 
-        // test points against all faces
-        Scalar d, dd;
-        Face ff;
-
-        for (auto point : points)
+        // assign each point to its closest face
+        collect_triangles(cd.v1, Face(), Face(), triangles_);
+        Scalar dist;
+        for (const auto& point : points_)
         {
-            dd = std::numeric_limits<Scalar>::max();
-
-            for (auto f : mesh_.faces(cd.v1))
-            {
-                d = distance(f, point);
-                if (d < dd)
-                {
-                    ff = f;
-                    dd = d;
-                }
-            }
-
-            face_points_[ff].push_back(point);
+            const Face f = closest_triangle(point, triangles_, dist);
+            face_points_[f].push_back(point);
+            face_error_[f] = std::max(face_error_[f], dist);
         }
     }
 }
@@ -1177,17 +1013,88 @@ Scalar Decimation::aspect_ratio(Face f) const
     return l / a;
 }
 
-Scalar Decimation::distance(Face f, const Point& p) const
+Decimation::Triangle::Triangle(Face f, const Point& a, const Point& b,
+                               const Point& c)
+    : face(f), p0(a), p1(b), p2(c)
 {
-    auto fvit = mesh_.vertices(f);
+    center = (p0 + p1 + p2) / Scalar(3.0);
+    radius = std::max({sqrnorm(p0 - center), sqrnorm(p1 - center),
+                       sqrnorm(p2 - center)});
+    radius = std::sqrt(radius);
+}
 
-    const Point p0 = vpoint_[*fvit];
-    const Point p1 = vpoint_[*(++fvit)];
-    const Point p2 = vpoint_[*(++fvit)];
+void Decimation::collect_triangles(Vertex v, Face f0, Face f1,
+                                   Triangles& triangles)
+{
+    triangles.clear();
+    for (auto f : mesh_.faces(v))
+    {
+        if (f != f0 && f != f1)
+        {
+            auto fvit = mesh_.vertices(f);
+            const Point& a = vpoint_[*fvit];
+            const Point& b = vpoint_[*(++fvit)];
+            const Point& c = vpoint_[*(++fvit)];
+            triangles.emplace_back(f, a, b, c);
+        }
+    }
+}
 
+bool Decimation::is_within_error(const Point& p, const Triangles& triangles,
+                                 const Triangle* first) const
+{
     Point n;
 
-    return dist_point_triangle(p, p0, p1, p2, n);
+    if (first &&
+        dist_point_triangle(p, first->p0, first->p1, first->p2, n) <
+            hausdorff_error_)
+        return true;
+
+    const Scalar sqr_error = hausdorff_error_ * hausdorff_error_;
+
+    // cheap accept: distance to a corner bounds the distance to the triangle
+    for (const auto& t : triangles)
+    {
+        if (sqrnorm(p - t.p0) < sqr_error || sqrnorm(p - t.p1) < sqr_error ||
+            sqrnorm(p - t.p2) < sqr_error)
+            return true;
+    }
+
+    // exact test, skipping triangles whose bounding sphere is too far away
+    for (const auto& t : triangles)
+    {
+        if (&t == first || t.min_distance(p) >= hausdorff_error_)
+            continue;
+        if (dist_point_triangle(p, t.p0, t.p1, t.p2, n) < hausdorff_error_)
+            return true;
+    }
+
+    return false;
+}
+
+Face Decimation::closest_triangle(const Point& p, const Triangles& triangles,
+                                  Scalar& dist) const
+{
+    Scalar d, dd = std::numeric_limits<Scalar>::max();
+    Face closest;
+    Point n;
+
+    for (const auto& t : triangles)
+    {
+        // the bounding sphere cannot contain a closer point
+        if (t.min_distance(p) >= dd)
+            continue;
+
+        d = dist_point_triangle(p, t.p0, t.p1, t.p2, n);
+        if (d < dd)
+        {
+            closest = t.face;
+            dd = d;
+        }
+    }
+
+    dist = dd;
+    return closest;
 }
 
 Decimation::CollapseData::CollapseData(SurfaceMesh& sm, Halfedge h) : mesh(sm)
@@ -3,6 +3,10 @@
 
 #include "pmp/algorithms/fairing.h"
 #include "pmp/algorithms/laplace.h"
+#include "pmp/algorithms/multigrid.h"
+
+#include <algorithm>
+#include <exception>
 
 namespace pmp {
 
@@ -16,14 +20,17 @@ void minimize_curvature(SurfaceMesh& mesh)
     fair(mesh, 2);
 }
 
-void fair(SurfaceMesh& mesh, unsigned int k)
+namespace {
+
+// Lock k boundary rings, unselected vertices if there is a selection, and
+// isolated vertices. The locked vertices are the boundary constraints of the
+// k-harmonic equation.
+std::vector<bool> locked_vertices(const SurfaceMesh& mesh, unsigned int k)
 {
-    // get & add properties
-    auto vselected = mesh.get_vertex_property<bool>("v:selected");
-    auto vlocked = mesh.add_vertex_property<bool>("fairing:locked");
-    auto cleanup = [&]() { mesh.remove_vertex_property(vlocked); };
+    std::vector<bool> locked(mesh.vertices_size(), false);
 
     // check whether some vertices are selected
+    auto vselected = mesh.get_vertex_property<bool>("v:selected");
     bool no_selection = true;
     if (vselected)
     {
@@ -43,21 +50,21 @@ void fair(SurfaceMesh& mesh, unsigned int k)
         // lock boundary
         if (mesh.is_boundary(v))
         {
-            vlocked[v] = true;
+            locked[v.idx()] = true;
 
             // lock one-ring of boundary
             if (k > 1)
             {
                 for (auto vv : mesh.vertices(v))
                 {
-                    vlocked[vv] = true;
+                    locked[vv.idx()] = true;
 
                     // lock two-ring of boundary
                     if (k > 2)
                     {
                         for (auto vvv : mesh.vertices(vv))
                         {
-                            vlocked[vvv] = true;
+                            locked[vvv.idx()] = true;
                         }
                     }
                 }
@@ -70,32 +77,43 @@ void fair(SurfaceMesh& mesh, unsigned int k)
     {
         if (!no_selection && !vselected[v])
         {
-            vlocked[v] = true;
+            locked[v.idx()] = true;
         }
 
         if (mesh.is_isolated(v))
         {
-            vlocked[v] = true;
+            locked[v.idx()] = true;
         }
     }
 
     // we need locked vertices as boundary constraints
-    bool something_locked = false;
-    for (auto v : mesh.vertices())
-    {
-        if (vlocked[v])
-        {
-            something_locked = true;
-            break;
-        }
-    }
-    if (!something_locked)
+    if (std::ranges::find(locked, true) == locked.end())
     {
-        cleanup();
-        auto what = std::string{__func__} + ": Missing boundary constraints.";
-        throw InvalidInputException(what);
+        throw InvalidInputException("fair: Missing boundary constraints.");
     }
 
+    return locked;
+}
+
+// system matrix A = L (M^-1 L)^(k-1) of the k-harmonic equation
+SparseMatrix fairing_matrix(const SurfaceMesh& mesh, const DiagonalMatrix& M,
+                            unsigned int k)
+{
+    SparseMatrix L;
+    laplace_matrix(mesh, L);
+    const DiagonalMatrix Minv = M.inverse();
+    SparseMatrix A = L;
+    for (unsigned int i = 1; i < k; ++i)
+        A = L * Minv * A;
+    return A;
+}
+
+} // namespace
+
+void fair(SurfaceMesh& mesh, unsigned int k, LinearSolver solver)
+{
+    const std::vector<bool> locked = locked_vertices(mesh, k);
+
     const int n = mesh.n_vertices();
 
     // build (zero) right-hand side B
@@ -106,26 +124,133 @@ void fair(SurfaceMesh& mesh, unsigned int k)
     DenseMatrix X;
     coordinates_to_matrix(mesh, X);
 
-    // build matrix
-    SparseMatrix L;
-    laplace_matrix(mesh, L);
+    auto is_locked = [&](unsigned int i) { return locked[i]; };
     DiagonalMatrix M;
     mass_matrix(mesh, M);
-    const DiagonalMatrix Minv = M.inverse();
-    SparseMatrix A = L;
-    for (unsigned int i = 1; i < k; ++i)
-        A = L * Minv * A;
-    B = M * B;
 
-    // solve system
-    auto is_locked = [&](unsigned int i) { return vlocked[Vertex(i)]; };
-    X = cholesky_solve(A, B, is_locked, X);
+    if (solver == LinearSolver::ConjugateGradient)
+    {
+        // matrix-free operator A = (-1)^k L (M^-1 L)^(k-1), which is
+        // positive definite on the unlocked vertices
+        const LaplaceOperator L(mesh);
+        const DiagonalMatrix Minv = M.inverse();
+        const double sign = (k % 2) ? -1.0 : 1.0;
+        auto A = [&](const DenseMatrix& x, DenseMatrix& y) {
+            L.multiply(x, y);
+            for (unsigned int i = 1; i < k; ++i)
+            {
+                const DenseMatrix tmp = Minv * y;
+                L.multiply(tmp, y);
+            }
+            y *= sign;
+        };
+
+        // Jacobi preconditioner for k = 1 and k = 2
+        Eigen::VectorXd diagonal;
+        if (k == 1)
+        {
+            diagonal = -L.diagonal();
+        }
+        else if (k == 2)
+        {
+            const Eigen::VectorXd Ldiag = L.diagonal();
+            diagonal = Ldiag.cwiseAbs2().cwiseProduct(Minv.diagonal());
+            for (auto v : mesh.vertices())
+            {
+                for (auto h : mesh.halfedges(v))
+                {
+                    const double w = L.weight(mesh.edge(h));
+                    diagonal[v.idx()] +=
+                        w * w * Minv.diagonal()[mesh.to_vertex(h).idx()];
+                }
+            }
+        }
+
+        conjugate_gradient_solve(A, diagonal, B, X, is_locked);
+    }
+    else
+    {
+        // build matrix
+        SparseMatrix A = fairing_matrix(mesh, M, k);
+        B = M * B;
+
+        // solve system
+        if (solver == LinearSolver::Multigrid)
+        {
+            // multigrid requires A to be positive definite
+            if (k % 2)
+                A = -A;
+            MultigridSolver multigrid(mesh);
+            multigrid.compute(A, is_locked);
+            multigrid.solve(B, X);
+        }
+        else
+        {
+            X = cholesky_solve(A, B, is_locked, X);
+        }
+    }
 
     // copy solution
     matrix_to_coordinates(X, mesh);
+}
+
+void fair(const SurfaceMesh& mesh, std::vector<std::vector<Point>>& frames,
+          unsigned int k)
+{
+    check_frames(mesh, frames, __func__);
+    if (frames.empty())
+        return;
+
+    // the constraints only depend on the connectivity and selection
+    const std::vector<bool> locked = locked_vertices(mesh, k);
+    auto is_locked = [&](unsigned int i) { return locked[i]; };
+
+    const int n = mesh.n_vertices();
+    const int n_frames = frames.size();
+
+    // the first exception thrown in the parallel region, rethrown afterwards
+    std::exception_ptr exception;
+
+    // the system matrix depends on the positions: each thread reuses the
+    // symbolic analysis of its solver for all of its frames
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        SurfaceMesh frame_mesh = mesh;
+        ConstrainedSolver cholesky(n, is_locked);
+        DiagonalMatrix M;
+        DenseMatrix X;
+        const DenseMatrix B = DenseMatrix::Zero(n, 3);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int f = 0; f < n_frames; ++f)
+        {
+            try
+            {
+                // positions are used as constraints
+                frame_mesh.positions() = frames[f];
+                mass_matrix(frame_mesh, M);
+                coordinates_to_matrix(frame_mesh, X);
+                X = cholesky.solve(fairing_matrix(frame_mesh, M, k), B, X);
+                matrix_to_coordinates(X, frame_mesh);
+                frames[f] = frame_mesh.positions();
+            }
+            catch (...)
+            {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exception)
+                    exception = std::current_exception();
+            }
+        }
+    }
 
-    // remove properties
-    cleanup();
+    if (exception)
+        std::rethrow_exception(exception);
 }
 
 } // namespace pmp
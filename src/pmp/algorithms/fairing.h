@@ -4,6 +4,7 @@
 #pragma once
 
 #include "pmp/surface_mesh.h"
+#include "pmp/algorithms/numerics.h"
 
 namespace pmp {
 
@@ -21,10 +22,40 @@ void minimize_curvature(SurfaceMesh& mesh);
 
 //! \brief Implicit surface fairing.
 //! \details Computes a surface by solving k-harmonic equation. See also \cite desbrun_1999_implicit .
-//! \note This algorithm works on general polygon meshes.
+//! \note This algorithm works on general polygon meshes. The matrix-free
+//! conjugate gradient and the multigrid solver require a triangle mesh.
+//! \param mesh The input mesh, modified in place.
+//! \param k The order of the k-harmonic equation.
+//! \param solver The linear solver. The conjugate gradient solver requires
+//! much less memory for large meshes, but converges slowly for k > 1. The
+//! multigrid solver scales to large meshes and requires a triangle mesh.
+//! LinearSolver::MixedPrecision falls back to Cholesky, since the k-harmonic
+//! systems are too ill-conditioned for a single precision factorization.
+//! \throw SolverException in case of failure to solve the linear system
+//! \throw InvalidInputException in case of missing boundary constraints or
+//! if the conjugate gradient or multigrid solver is used on a non-triangle
+//! mesh
+//! \ingroup algorithms
+void fair(SurfaceMesh& mesh, unsigned int k = 2,
+          LinearSolver solver = LinearSolver::Cholesky);
+
+//! \brief Implicit surface fairing of several frames of a mesh.
+//! \details All frames share the connectivity and the vertex selection of
+//! \p mesh, e.g., the frames of an animation, such that the constrained
+//! vertices are the same for all frames. The symbolic analysis of the
+//! Cholesky factorization is reused across frames, and frames are processed
+//! in parallel if OpenMP is available.
+//! \param mesh The mesh providing the connectivity and the selection. Its
+//! positions are ignored.
+//! \param frames The vertex positions of each frame, indexed by vertex index,
+//! modified in place.
+//! \param k The order of the k-harmonic equation.
 //! \throw SolverException in case of failure to solve the linear system
-//! \throw InvalidInputException in case of missing boundary constraints
+//! \throw InvalidInputException in case of missing boundary constraints, if
+//! the mesh has deleted vertices, or if the size of a frame differs from the
+//! number of vertices
 //! \ingroup algorithms
-void fair(SurfaceMesh& mesh, unsigned int k = 2);
+void fair(const SurfaceMesh& mesh, std::vector<std::vector<Point>>& frames,
+          unsigned int k = 2);
 
 } // namespace pmp
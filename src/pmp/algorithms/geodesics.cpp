@@ -3,95 +3,27 @@
 
 #include "pmp/algorithms/geodesics.h"
 #include "pmp/algorithms/laplace.h"
+#include "pmp/exceptions.h"
 
 #include <algorithm>
 #include <cassert>
-#include <set>
-#include <map>
 #include <numbers>
+#include <string>
 
 namespace pmp {
-namespace {
-
-class Geodesics
-{
-public:
-    Geodesics(SurfaceMesh& mesh, bool use_virtual_edges = true);
-    ~Geodesics();
-    unsigned int compute(
-        const std::vector<Vertex>& seed,
-        Scalar maxdist = std::numeric_limits<Scalar>::max(),
-        unsigned int maxnum = std::numeric_limits<unsigned int>::max(),
-        std::vector<Vertex>* neighbors = nullptr);
-
-private:
-    // functor for comparing two vertices w.r.t. their geodesic distance
-    class VertexCmp
-    {
-    public:
-        VertexCmp(const VertexProperty<Scalar>& dist) : dist_(dist) {}
-
-        bool operator()(Vertex v0, Vertex v1) const
-        {
-            return ((dist_[v0] == dist_[v1]) ? (v0 < v1)
-                                             : (dist_[v0] < dist_[v1]));
-        }
-
-    private:
-        const VertexProperty<Scalar>& dist_;
-    };
-
-    // priority queue using geodesic distance as sorting criterion
-    using PriorityQueue = std::set<Vertex, VertexCmp>;
-
-    // virtual edges for walking through obtuse triangles
-    struct VirtualEdge
-    {
-        VirtualEdge(Vertex v, Scalar l) : vertex(v), length(l) {}
-        Vertex vertex;
-        Scalar length;
-    };
-
-    // set for storing virtual edges
-    using VirtualEdges = std::map<Halfedge, VirtualEdge>;
-
-    void find_virtual_edges();
-    unsigned int init_front(const std::vector<Vertex>& seed,
-                            std::vector<Vertex>* neighbors);
-    unsigned int propagate_front(Scalar maxdist, unsigned int maxnum,
-                                 std::vector<Vertex>* neighbors);
-    void heap_vertex(Vertex v);
-    Scalar distance(Vertex v0, Vertex v1, Vertex v2,
-                    Scalar r0 = std::numeric_limits<Scalar>::max(),
-                    Scalar r1 = std::numeric_limits<Scalar>::max());
-
-    SurfaceMesh& mesh_;
-
-    bool use_virtual_edges_;
-    VirtualEdges virtual_edges_;
-
-    PriorityQueue* front_;
-
-    VertexProperty<Scalar> distance_;
-    VertexProperty<bool> processed_;
-};
-
-Geodesics::Geodesics(SurfaceMesh& mesh, bool use_virtual_edges)
-    : mesh_(mesh), use_virtual_edges_(use_virtual_edges)
-{
-    distance_ = mesh_.vertex_property<Scalar>("geodesic:distance");
-    processed_ = mesh_.add_vertex_property<bool>("geodesic:processed");
 
-    if (use_virtual_edges_)
-        find_virtual_edges();
-}
-
-Geodesics::~Geodesics()
+GeodesicSolver::GeodesicSolver(const SurfaceMesh& mesh, bool use_virtual_edges)
+    : mesh_(mesh),
+      distance_(mesh.vertices_size(), std::numeric_limits<Scalar>::max()),
+      processed_(mesh.vertices_size(), false),
+      is_touched_(mesh.vertices_size(), false),
+      heap_pos_(mesh.vertices_size(), -1),
+      front_(HeapInterface(&distance_, &heap_pos_))
 {
-    mesh_.remove_vertex_property(processed_);
+    find_wedges(use_virtual_edges);
 }
 
-void Geodesics::find_virtual_edges()
+void GeodesicSolver::find_wedges(bool use_virtual_edges)
 {
     Halfedge hh, hhh;
     Vertex vh0, vh1, vhn, start_vh0, start_vh1;
@@ -104,10 +36,18 @@ void Geodesics::find_virtual_edges()
     const Scalar max_angle = 90.0 / 180.0 * std::numbers::pi;
     const Scalar max_angle_cos = cos(max_angle);
 
-    virtual_edges_.clear();
+    wedge_offsets_.assign(mesh_.vertices_size() + 1, 0);
+    wedges_.clear();
+    wedges_.reserve(mesh_.halfedges_size());
 
-    for (auto vv : mesh_.vertices())
+    for (size_t i = 0; i < mesh_.vertices_size(); ++i)
     {
+        wedge_offsets_[i] = wedges_.size();
+
+        const Vertex vv(i);
+        if (mesh_.is_deleted(vv))
+            continue;
+
         pp = mesh_.position(vv);
 
         for (auto h : mesh_.halfedges(vv))
@@ -118,13 +58,15 @@ void Geodesics::find_virtual_edges()
                 hh = mesh_.next_halfedge(h);
                 vh1 = mesh_.to_vertex(hh);
 
+                Wedge wedge{vh0, vh1, Vertex(), 0};
+
                 p0 = mesh_.position(vh0);
                 p1 = mesh_.position(vh1);
                 d0 = normalize(p0 - pp);
                 d1 = normalize(p1 - pp);
 
                 // obtuse angle ?
-                if (dot(d0, d1) < max_angle_cos)
+                if (use_virtual_edges && dot(d0, d1) < max_angle_cos)
                 {
                     // compute angles
                     alpha = 0.5 * acos(std::min(
@@ -167,9 +109,8 @@ void Geodesics::find_virtual_edges()
                         // point in tolerance?
                         if ((fabs(vn[1]) / fabs(vn[0])) < tan_beta)
                         {
-                            virtual_edges_.insert(
-                                std::pair<Halfedge, VirtualEdge>(
-                                    h, VirtualEdge(vhn, norm(vn))));
+                            wedge.virtual_vertex = vhn;
+                            wedge.virtual_length = norm(vn);
                             break;
                         }
 
@@ -194,27 +135,56 @@ void Geodesics::find_virtual_edges()
                         hhh = mesh_.opposite_halfedge(hh);
                     }
                 }
+
+                wedges_.push_back(wedge);
             }
         }
     }
+
+    wedge_offsets_.back() = wedges_.size();
+}
+
+void GeodesicSolver::reset()
+{
+    for (auto v : touched_)
+    {
+        distance_[v.idx()] = std::numeric_limits<Scalar>::max();
+        processed_[v.idx()] = false;
+        is_touched_[v.idx()] = false;
+        heap_pos_[v.idx()] = -1;
+    }
+    touched_.clear();
+    front_.clear();
 }
 
-unsigned int Geodesics::compute(const std::vector<Vertex>& seed, Scalar maxdist,
-                                unsigned int maxnum,
-                                std::vector<Vertex>* neighbors)
+void GeodesicSolver::touch(Vertex v)
+{
+    if (!is_touched_[v.idx()])
+    {
+        is_touched_[v.idx()] = true;
+        touched_.push_back(v);
+    }
+}
+
+unsigned int GeodesicSolver::compute(const std::vector<Vertex>& seeds,
+                                     Scalar maxdist, unsigned int maxnum,
+                                     std::vector<Vertex>* neighbors)
 {
     unsigned int num(0);
 
-    // generate front
-    front_ = new PriorityQueue(VertexCmp(distance_));
+    // reset vertices touched by the previous call
+    reset();
 
     // initialize front with given seed
-    num = init_front(seed, neighbors);
+    num = init_front(seeds, neighbors);
 
     // sort one-ring neighbors of seed vertices
     if (neighbors)
     {
-        std::ranges::sort(*neighbors, VertexCmp(distance_));
+        const HeapInterface cmp(&distance_, &heap_pos_);
+        std::ranges::sort(*neighbors, [&cmp](Vertex v0, Vertex v1) {
+            return cmp.less(v0, v1);
+        });
     }
 
     // correct if seed vertices have more than maxnum neighbors
@@ -229,49 +199,57 @@ unsigned int Geodesics::compute(const std::vector<Vertex>& seed, Scalar maxdist,
     if (num < maxnum)
         num += propagate_front(maxdist, maxnum - num, neighbors);
 
-    // clean up
-    delete front_;
-
     return num;
 }
 
-unsigned int Geodesics::init_front(const std::vector<Vertex>& seed,
-                                   std::vector<Vertex>* neighbors)
+unsigned int GeodesicSolver::compute(const std::vector<Vertex>& seeds,
+                                     const std::vector<Scalar>& bounds)
 {
-    unsigned int num(0);
-
-    if (seed.empty())
-        return num;
-
-    // reset all vertices
-    for (auto v : mesh_.vertices())
+    if (bounds.size() != distance_.size())
     {
-        processed_[v] = false;
-        distance_[v] = std::numeric_limits<Scalar>::max();
+        auto what = std::string{__func__} +
+                    ": Number of bounds differs from number of vertices.";
+        throw InvalidInputException(what);
     }
 
+    bounds_ = &bounds;
+    const unsigned int num = compute(seeds);
+    bounds_ = nullptr;
+    return num;
+}
+
+unsigned int GeodesicSolver::init_front(const std::vector<Vertex>& seeds,
+                                        std::vector<Vertex>* neighbors)
+{
+    unsigned int num(0);
+
     // initialize neighbor array
     if (neighbors)
         neighbors->clear();
 
+    if (seeds.empty())
+        return num;
+
     // initialize seed vertices
-    for (auto v : seed)
+    for (auto v : seeds)
     {
-        processed_[v] = true;
-        distance_[v] = 0.0;
+        touch(v);
+        processed_[v.idx()] = true;
+        distance_[v.idx()] = 0.0;
     }
 
     // initialize seed's one-ring
-    for (auto v : seed)
+    for (auto v : seeds)
     {
         for (auto vv : mesh_.vertices(v))
         {
             const Scalar dist =
                 pmp::distance(mesh_.position(v), mesh_.position(vv));
-            if (dist < distance_[vv])
+            if (dist < distance_[vv.idx()])
             {
-                distance_[vv] = dist;
-                processed_[vv] = true;
+                touch(vv);
+                distance_[vv.idx()] = dist;
+                processed_[vv.idx()] = true;
                 ++num;
                 if (neighbors)
                     neighbors->push_back(vv);
@@ -280,14 +258,13 @@ unsigned int Geodesics::init_front(const std::vector<Vertex>& seed,
     }
 
     // init marching front
-    front_->clear();
-    for (auto v : seed)
+    for (auto v : seeds)
     {
         for (auto vv : mesh_.vertices(v))
         {
             for (auto vvv : mesh_.vertices(vv))
             {
-                if (!processed_[vvv])
+                if (!processed_[vvv.idx()])
                 {
                     heap_vertex(vvv);
                 }
@@ -298,34 +275,39 @@ unsigned int Geodesics::init_front(const std::vector<Vertex>& seed,
     return num;
 }
 
-unsigned int Geodesics::propagate_front(Scalar maxdist, unsigned int maxnum,
-                                        std::vector<Vertex>* neighbors)
+unsigned int GeodesicSolver::propagate_front(Scalar maxdist,
+                                             unsigned int maxnum,
+                                             std::vector<Vertex>* neighbors)
 {
     unsigned int num(0);
 
-    while (!front_->empty())
+    while (!front_.empty())
     {
         // find minimum vertex, remove it from queue
-        auto v = *front_->begin();
-        front_->erase(front_->begin());
-        assert(!processed_[v]);
-        processed_[v] = true;
+        auto v = front_.front();
+        front_.pop_front();
+        assert(!processed_[v.idx()]);
+        processed_[v.idx()] = true;
         ++num;
         if (neighbors)
             neighbors->push_back(v);
 
         // did we reach maximum distance?
-        if (distance_[v] > maxdist)
+        if (distance_[v.idx()] > maxdist)
             break;
 
         // did we reach maximum number of neighbors
         if (num >= maxnum)
             break;
 
+        // no improvement over the given bound, stop propagating here
+        if (bounds_ && distance_[v.idx()] >= (*bounds_)[v.idx()])
+            continue;
+
         // update front
         for (auto vv : mesh_.vertices(v))
         {
-            if (!processed_[vv])
+            if (!processed_[vv.idx()])
             {
                 heap_vertex(vv);
             }
@@ -335,66 +317,59 @@ unsigned int Geodesics::propagate_front(Scalar maxdist, unsigned int maxnum,
     return num;
 }
 
-void Geodesics::heap_vertex(Vertex v)
+void GeodesicSolver::heap_vertex(Vertex v)
 {
-    assert(!processed_[v]);
+    assert(!processed_[v.idx()]);
 
-    Vertex v0, v1, vv;
-    Scalar dist, dist_min(std::numeric_limits<Scalar>::max()), d;
-    typename VirtualEdges::const_iterator ve_it, ve_end(virtual_edges_.end());
+    Scalar dist, dist_min(std::numeric_limits<Scalar>::max());
     bool found(false);
 
-    for (auto h : mesh_.halfedges(v))
+    const auto begin = wedges_.begin() + wedge_offsets_[v.idx()];
+    const auto end = wedges_.begin() + wedge_offsets_[v.idx() + 1];
+    for (auto w = begin; w != end; ++w)
     {
-        if (!mesh_.is_boundary(h))
-        {
-            ve_it = virtual_edges_.find(h);
+        const bool processed0 = processed_[w->v0.idx()];
+        const bool processed1 = processed_[w->v1.idx()];
 
-            // no virtual edge
-            if (ve_it == ve_end)
+        // no virtual edge
+        if (!w->virtual_vertex.is_valid())
+        {
+            if (processed0 && processed1)
             {
-                v0 = mesh_.to_vertex(h);
-                v1 = mesh_.to_vertex(mesh_.next_halfedge(h));
-
-                if (processed_[v0] && processed_[v1])
+                dist = distance(w->v0, w->v1, v);
+                if (dist < dist_min)
                 {
-                    dist = distance(v0, v1, v);
-                    if (dist < dist_min)
-                    {
-                        dist_min = dist;
-                        found = true;
-                    }
+                    dist_min = dist;
+                    found = true;
                 }
             }
+        }
 
-            // virtual edge
-            else
-            {
-                v0 = mesh_.to_vertex(h);
-                v1 = mesh_.to_vertex(mesh_.next_halfedge(h));
-                vv = ve_it->second.vertex;
-                d = ve_it->second.length;
+        // virtual edge
+        else if (processed_[w->virtual_vertex.idx()])
+        {
+            const Vertex vv = w->virtual_vertex;
+            const Scalar d = w->virtual_length;
 
-                if (processed_[v0] && processed_[vv])
+            if (processed0)
+            {
+                dist = distance(w->v0, vv, v,
+                                std::numeric_limits<Scalar>::max(), d);
+                if (dist < dist_min)
                 {
-                    dist = distance(v0, vv, v,
-                                    std::numeric_limits<Scalar>::max(), d);
-                    if (dist < dist_min)
-                    {
-                        dist_min = dist;
-                        found = true;
-                    }
+                    dist_min = dist;
+                    found = true;
                 }
+            }
 
-                if (processed_[v1] && processed_[vv])
+            if (processed1)
+            {
+                dist = distance(vv, w->v1, v, d,
+                                std::numeric_limits<Scalar>::max());
+                if (dist < dist_min)
                 {
-                    dist = distance(vv, v1, v, d,
-                                    std::numeric_limits<Scalar>::max());
-                    if (dist < dist_min)
-                    {
-                        dist_min = dist;
-                        found = true;
-                    }
+                    dist_min = dist;
+                    found = true;
                 }
             }
         }
@@ -403,41 +378,36 @@ void Geodesics::heap_vertex(Vertex v)
     // update priority queue
     if (found)
     {
-        if (distance_[v] != std::numeric_limits<Scalar>::max())
-        {
-            auto it = front_->find(v);
-            assert(it != front_->end());
-            front_->erase(it);
-        }
-
-        distance_[v] = dist_min;
-        front_->insert(v);
+        touch(v);
+        distance_[v.idx()] = dist_min;
+        if (front_.is_stored(v))
+            front_.update(v);
+        else
+            front_.insert(v);
     }
     else
     {
-        if (distance_[v] != std::numeric_limits<Scalar>::max())
-        {
-            front_->erase(v);
-            distance_[v] = std::numeric_limits<Scalar>::max();
-        }
+        if (front_.is_stored(v))
+            front_.remove(v);
+        distance_[v.idx()] = std::numeric_limits<Scalar>::max();
     }
 }
 
-Scalar Geodesics::distance(Vertex v0, Vertex v1, Vertex v2, Scalar r0,
-                           Scalar r1)
+Scalar GeodesicSolver::distance(Vertex v0, Vertex v1, Vertex v2, Scalar r0,
+                                Scalar r1) const
 {
     Point A, B, C;
     double TA, TB;
     double a, b;
 
     // choose points such that TB>TA and hence u>0
-    if (distance_[v0] < distance_[v1])
+    if (distance_[v0.idx()] < distance_[v1.idx()])
     {
         A = mesh_.position(v0);
         B = mesh_.position(v1);
         C = mesh_.position(v2);
-        TA = distance_[v0];
-        TB = distance_[v1];
+        TA = distance_[v0.idx()];
+        TB = distance_[v1.idx()];
         a = r1 == std::numeric_limits<Scalar>::max() ? pmp::distance(B, C) : r1;
         b = r0 == std::numeric_limits<Scalar>::max() ? pmp::distance(A, C) : r0;
     }
@@ -446,8 +416,8 @@ Scalar Geodesics::distance(Vertex v0, Vertex v1, Vertex v2, Scalar r0,
         A = mesh_.position(v1);
         B = mesh_.position(v0);
         C = mesh_.position(v2);
-        TA = distance_[v1];
-        TB = distance_[v0];
+        TA = distance_[v1.idx()];
+        TB = distance_[v0.idx()];
         a = r0 == std::numeric_limits<Scalar>::max() ? pmp::distance(B, C) : r0;
         b = r1 == std::numeric_limits<Scalar>::max() ? pmp::distance(A, C) : r1;
     }
@@ -482,6 +452,8 @@ Scalar Geodesics::distance(Vertex v0, Vertex v1, Vertex v2, Scalar r0,
     return dijkstra;
 }
 
+namespace {
+
 Scalar max_diagonal_length(const SurfaceMesh& mesh)
 {
     Scalar maxdiag(0.0), length;
@@ -502,8 +474,98 @@ Scalar max_diagonal_length(const SurfaceMesh& mesh)
     return maxdiag;
 }
 
+// normalize the 3D gradient vectors stored in the columns of grad
+void normalize_gradients(DenseMatrix& grad)
+{
+    for (Eigen::Index j = 0; j < grad.cols(); ++j)
+    {
+        for (Eigen::Index i = 0; i < grad.rows(); i += 3)
+        {
+            auto g = grad.block<3, 1>(i, j);
+            const double ng = g.norm();
+            if (ng > std::numeric_limits<double>::min())
+            {
+                g /= ng;
+            }
+        }
+    }
+}
+
 } // namespace
 
+HeatGeodesics::HeatGeodesics(const SurfaceMesh& mesh)
+{
+    // setup all matrices
+    DiagonalMatrix M;
+    gradient_matrix(mesh, G_);
+    divergence_matrix(mesh, D_);
+    mass_matrix(mesh, M);
+    const SparseMatrix L = D_ * G_;
+
+    // diffusion time step (squared mean edge length)
+    const double h = max_diagonal_length(mesh);
+    const double dt = h * h;
+
+    // factorize heat diffusion and Poisson systems
+    heat_solver_.compute(SparseMatrix(M) - dt * L);
+    poisson_solver_.compute(L);
+    if (heat_solver_.info() != Eigen::Success ||
+        poisson_solver_.info() != Eigen::Success)
+    {
+        auto what =
+            std::string{__func__} + ": Failed to factorize linear system.";
+        throw SolverException(what);
+    }
+}
+
+Eigen::VectorXd HeatGeodesics::compute(const std::vector<Vertex>& seeds) const
+{
+    return compute(std::vector<std::vector<Vertex>>{seeds}).col(0);
+}
+
+DenseMatrix HeatGeodesics::compute(
+    const std::vector<std::vector<Vertex>>& seeds) const
+{
+    const Eigen::Index n = G_.cols();
+    const Eigen::Index k = seeds.size();
+
+    // solve heat diffusion from seed points
+    DenseMatrix b = DenseMatrix::Zero(n, k);
+    for (Eigen::Index j = 0; j < k; ++j)
+    {
+        for (auto s : seeds[j])
+        {
+            b(s.idx(), j) = 1.0;
+        }
+    }
+    const DenseMatrix heat = heat_solver_.solve(b);
+    if (heat_solver_.info() != Eigen::Success)
+    {
+        auto what = std::string{__func__} + ": Failed to solve linear system.";
+        throw SolverException(what);
+    }
+
+    // compute and normalize heat gradient
+    DenseMatrix grad = G_ * heat;
+    normalize_gradients(grad);
+
+    // solve Poisson system for distances
+    DenseMatrix dist = poisson_solver_.solve(D_ * (-grad));
+    if (poisson_solver_.info() != Eigen::Success)
+    {
+        auto what = std::string{__func__} + ": Failed to solve linear system.";
+        throw SolverException(what);
+    }
+
+    // shift distances value such that min dist is zero
+    for (Eigen::Index j = 0; j < k; ++j)
+    {
+        dist.col(j).array() -= dist.col(j).minCoeff();
+    }
+
+    return dist;
+}
+
 void distance_to_texture_coordinates(SurfaceMesh& mesh)
 {
     auto distance = mesh.get_vertex_property<Scalar>("geodesic:distance");
@@ -537,55 +599,193 @@ unsigned int geodesics(SurfaceMesh& mesh, const std::vector<Vertex>& seed,
                        Scalar maxdist, unsigned int maxnum,
                        std::vector<Vertex>* neighbors)
 {
-    return Geodesics(mesh, true /*virtual edges*/)
-        .compute(seed, maxdist, maxnum, neighbors);
+    GeodesicSolver solver(mesh);
+    const unsigned int num = solver.compute(seed, maxdist, maxnum, neighbors);
+
+    // copy result
+    auto distance = mesh.vertex_property<Scalar>("geodesic:distance");
+    for (auto v : mesh.vertices())
+        distance[v] = solver.distance(v);
+
+    return num;
 }
 
-void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seed)
+Eigen::MatrixXf geodesic_distance_matrix(const SurfaceMesh& mesh,
+                                         const std::vector<Vertex>& sources,
+                                         const std::vector<Vertex>& targets,
+                                         Scalar maxdist)
 {
-    const unsigned int n = mesh.n_vertices();
+    const int n_sources = sources.size();
+    Eigen::MatrixXf result(n_sources, targets.size());
 
-    // setup all matrices
-    SparseMatrix G, D, L;
-    DiagonalMatrix M;
-    gradient_matrix(mesh, G);
-    divergence_matrix(mesh, D);
-    mass_matrix(mesh, M);
-    L = D * G;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        GeodesicSolver solver(mesh);
 
-    // diffusion time step (squared mean edge length)
-    const double h = max_diagonal_length(mesh);
-    const double dt = h * h;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < n_sources; ++i)
+        {
+            solver.compute(std::vector<Vertex>{sources[i]}, maxdist);
+            for (size_t j = 0; j < targets.size(); ++j)
+            {
+                const Scalar d = solver.distance(targets[j]);
+                result(i, j) =
+                    d > maxdist ? std::numeric_limits<float>::max() : float(d);
+            }
+        }
+    }
 
-    // solve heat diffusion from seed points
-    const SparseMatrix A = SparseMatrix(M) - dt * L;
-    Eigen::SparseVector<double> b(n);
-    for (auto s : seed)
+    return result;
+}
+
+namespace {
+
+// heap interface sorting vertices by decreasing distance
+class FarthestHeapInterface
+{
+public:
+    FarthestHeapInterface(const std::vector<Scalar>* distance,
+                          std::vector<int>* heap_pos)
+        : distance_(distance), heap_pos_(heap_pos)
     {
-        b.coeffRef(s.idx()) = 1.0;
     }
-    const Eigen::VectorXd heat = cholesky_solve(A, b);
 
-    // compute and normalize heat gradient
-    Eigen::VectorXd grad = G * heat;
-    for (int i = 0; i < grad.rows(); i += 3)
+    bool less(Vertex v0, Vertex v1) const
     {
-        dvec3& g = *reinterpret_cast<dvec3*>(&grad[i]);
-        const double ng = norm(g);
-        if (ng > std::numeric_limits<double>::min())
+        const Scalar d0 = (*distance_)[v0.idx()];
+        const Scalar d1 = (*distance_)[v1.idx()];
+        return (d0 == d1) ? (v0 < v1) : (d0 > d1);
+    }
+    bool greater(Vertex v0, Vertex v1) const { return less(v1, v0); }
+    int get_heap_position(Vertex v) const { return (*heap_pos_)[v.idx()]; }
+    void set_heap_position(Vertex v, int pos) { (*heap_pos_)[v.idx()] = pos; }
+
+private:
+    const std::vector<Scalar>* distance_;
+    std::vector<int>* heap_pos_;
+};
+
+// Farthest point sampling until either max_samples samples have been
+// selected or the farthest vertex is closer than min_distance to the samples.
+std::vector<Vertex> farthest_samples(const SurfaceMesh& mesh,
+                                     unsigned int max_samples,
+                                     Scalar min_distance)
+{
+    std::vector<Vertex> samples;
+    if (mesh.is_empty() || max_samples == 0)
+        return samples;
+
+    // distance of each vertex to the closest sample so far
+    std::vector<Scalar> distance(mesh.vertices_size(),
+                                 std::numeric_limits<Scalar>::max());
+    std::vector<int> heap_pos(mesh.vertices_size(), -1);
+    Heap<Vertex, FarthestHeapInterface> candidates(
+        FarthestHeapInterface(&distance, &heap_pos));
+    candidates.reserve(mesh.n_vertices());
+    for (auto v : mesh.vertices())
+        candidates.insert(v);
+
+    GeodesicSolver solver(mesh);
+    while (samples.size() < max_samples && !candidates.empty())
+    {
+        // the farthest vertex becomes the next sample
+        const Vertex s = candidates.front();
+        if (distance[s.idx()] < min_distance)
+            break;
+        candidates.pop_front();
+        samples.push_back(s);
+        distance[s.idx()] = 0;
+
+        // propagate from the new sample only where it improves distances
+        solver.compute(std::vector<Vertex>{s}, distance);
+        for (auto v : solver.touched_vertices())
         {
-            g /= ng;
+            const Scalar d = solver.distance(v);
+            if (d < distance[v.idx()])
+            {
+                distance[v.idx()] = d;
+                if (candidates.is_stored(v))
+                    candidates.update(v);
+            }
         }
     }
 
-    // solve Poisson system for distances
-    Eigen::VectorXd dist = cholesky_solve(L, D * (-grad));
+    return samples;
+}
 
-    // shift distances value such that min dist is zero
-    const double mindist = dist.minCoeff();
-    for (int i = 0; i < dist.rows(); ++i)
+} // namespace
+
+std::vector<Vertex> farthest_point_sampling(const SurfaceMesh& mesh,
+                                            unsigned int n_samples)
+{
+    return farthest_samples(mesh, n_samples, 0);
+}
+
+std::vector<Vertex> poisson_disk_sampling(const SurfaceMesh& mesh,
+                                          Scalar radius)
+{
+    return farthest_samples(mesh, std::numeric_limits<unsigned int>::max(),
+                            radius);
+}
+
+void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seed,
+                    LinearSolver solver)
+{
+    Eigen::VectorXd dist;
+
+    if (solver == LinearSolver::ConjugateGradient)
+    {
+        // matrix-free Laplacian, gradient and divergence are assembled
+        const LaplaceOperator L(mesh);
+        const Eigen::VectorXd Ldiag = L.diagonal();
+        SparseMatrix G, D;
+        DiagonalMatrix M;
+        gradient_matrix(mesh, G);
+        divergence_matrix(mesh, D);
+        mass_matrix(mesh, M);
+
+        // diffusion time step (squared mean edge length)
+        const double h = max_diagonal_length(mesh);
+        const double dt = h * h;
+
+        // solve heat diffusion (M - dt L) heat = b from seed points
+        DenseMatrix LX;
+        auto A = [&](const DenseMatrix& x, DenseMatrix& y) {
+            L.multiply(x, LX);
+            y = M * x - dt * LX;
+        };
+        DenseMatrix b = DenseMatrix::Zero(mesh.n_vertices(), 1);
+        for (auto s : seed)
+            b(s.idx(), 0) = 1.0;
+        // heat decays quickly away from the seeds, but only the direction of
+        // its gradient matters, hence the tight tolerance
+        DenseMatrix heat = DenseMatrix::Zero(mesh.n_vertices(), 1);
+        conjugate_gradient_solve(A, M.diagonal() - dt * Ldiag, b, heat, {},
+                                 1e-12);
+
+        // compute and normalize heat gradient
+        DenseMatrix grad = G * heat;
+        normalize_gradients(grad);
+
+        // solve Poisson system -L dist = D grad
+        auto minus_L = [&](const DenseMatrix& x, DenseMatrix& y) {
+            L.multiply(x, y);
+            y = -y;
+        };
+        DenseMatrix X = DenseMatrix::Zero(mesh.n_vertices(), 1);
+        conjugate_gradient_solve(minus_L, -Ldiag, D * grad, X);
+        dist = X.col(0);
+
+        // shift distances value such that min dist is zero
+        dist.array() -= dist.minCoeff();
+    }
+    else
     {
-        dist[i] -= mindist;
+        dist = HeatGeodesics(mesh).compute(seed);
     }
 
     // copy result
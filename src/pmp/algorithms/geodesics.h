@@ -7,9 +7,137 @@
 #include <vector>
 
 #include "pmp/surface_mesh.h"
+#include "pmp/algorithms/heap.h"
+#include "pmp/algorithms/numerics.h"
 
 namespace pmp {
 
+//! \brief Reusable solver for fast-marching geodesic distances.
+//! \details Precomputes the virtual edges for walking through obtuse
+//! triangles once and keeps its heap and distance buffers between calls to
+//! compute(). Only the vertices touched by the previous call are reset, such
+//! that repeated local queries, e.g., bounded by a maximum distance or number
+//! of neighbors, do not scale with the size of the mesh.
+//! The solver keeps a reference to the mesh, which must not be modified as long
+//! as the solver is in use.
+//! See \cite kimmel_1998_geodesic for details.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \ingroup algorithms
+class GeodesicSolver
+{
+public:
+    //! \brief Construct a solver for \p mesh.
+    //! \param mesh The input mesh.
+    //! \param use_virtual_edges Whether to use virtual edges for walking
+    //! through obtuse triangles.
+    explicit GeodesicSolver(const SurfaceMesh& mesh,
+                            bool use_virtual_edges = true);
+
+    GeodesicSolver(const GeodesicSolver&) = delete;
+    GeodesicSolver& operator=(const GeodesicSolver&) = delete;
+
+    //! \brief Compute geodesic distances from a set of seed vertices.
+    //! \param[in] seeds The vector of seed vertices.
+    //! \param[in] maxdist The maximum distance up to which to compute the
+    //! geodesic distances.
+    //! \param[in] maxnum The maximum number of neighbors up to which to
+    //! compute the geodesic distances.
+    //! \param[out] neighbors The vector of neighbor vertices.
+    //! \return The number of neighbors that have been found.
+    unsigned int compute(
+        const std::vector<Vertex>& seeds,
+        Scalar maxdist = std::numeric_limits<Scalar>::max(),
+        unsigned int maxnum = std::numeric_limits<unsigned int>::max(),
+        std::vector<Vertex>* neighbors = nullptr);
+
+    //! \brief Compute geodesic distances bounded by a given distance field.
+    //! \details The front is not propagated beyond vertices whose distance is
+    //! not smaller than their bound. This allows to efficiently update a
+    //! distance field when adding seeds, e.g., for farthest point sampling.
+    //! \param[in] seeds The vector of seed vertices.
+    //! \param[in] bounds The bounds, indexed by vertex index.
+    //! \return The number of vertices that have been reached.
+    //! \throw InvalidInputException if the size of \p bounds differs from the
+    //! number of vertices of the mesh.
+    unsigned int compute(const std::vector<Vertex>& seeds,
+                         const std::vector<Scalar>& bounds);
+
+    //! \brief The distance of \p v computed by the last call to compute().
+    //! \details Vertices that have not been reached have distance
+    //! `std::numeric_limits<Scalar>::max()`.
+    Scalar distance(Vertex v) const { return distance_[v.idx()]; }
+
+    //! \brief The vertices touched by the last call to compute().
+    //! \details All other vertices have maximum distance.
+    const std::vector<Vertex>& touched_vertices() const { return touched_; }
+
+private:
+    // heap interface using geodesic distance as sorting criterion
+    class HeapInterface
+    {
+    public:
+        HeapInterface(const std::vector<Scalar>* distance,
+                      std::vector<int>* heap_pos)
+            : distance_(distance), heap_pos_(heap_pos)
+        {
+        }
+
+        bool less(Vertex v0, Vertex v1) const
+        {
+            const Scalar d0 = (*distance_)[v0.idx()];
+            const Scalar d1 = (*distance_)[v1.idx()];
+            return (d0 == d1) ? (v0 < v1) : (d0 < d1);
+        }
+        bool greater(Vertex v0, Vertex v1) const { return less(v1, v0); }
+        int get_heap_position(Vertex v) const { return (*heap_pos_)[v.idx()]; }
+        void set_heap_position(Vertex v, int pos)
+        {
+            (*heap_pos_)[v.idx()] = pos;
+        }
+
+    private:
+        const std::vector<Scalar>* distance_;
+        std::vector<int>* heap_pos_;
+    };
+
+    // The triangle spanned by an outgoing halfedge of a vertex. If the angle
+    // at the vertex is obtuse, the virtual edge to a vertex found by unfolding
+    // the adjacent triangles is stored as well.
+    struct Wedge
+    {
+        Vertex v0, v1;         // the opposite edge of the triangle
+        Vertex virtual_vertex; // invalid if there is no virtual edge
+        Scalar virtual_length;
+    };
+
+    void find_wedges(bool use_virtual_edges);
+    void reset();
+    void touch(Vertex v);
+    unsigned int init_front(const std::vector<Vertex>& seeds,
+                            std::vector<Vertex>* neighbors);
+    unsigned int propagate_front(Scalar maxdist, unsigned int maxnum,
+                                 std::vector<Vertex>* neighbors);
+    void heap_vertex(Vertex v);
+    Scalar distance(Vertex v0, Vertex v1, Vertex v2,
+                    Scalar r0 = std::numeric_limits<Scalar>::max(),
+                    Scalar r1 = std::numeric_limits<Scalar>::max()) const;
+
+    const SurfaceMesh& mesh_;
+
+    // wedges of vertex v are stored in [wedge_offsets_[v], wedge_offsets_[v+1])
+    std::vector<unsigned int> wedge_offsets_;
+    std::vector<Wedge> wedges_;
+
+    std::vector<Scalar> distance_;
+    std::vector<char> processed_;
+    std::vector<char> is_touched_;
+    std::vector<int> heap_pos_;
+    std::vector<Vertex> touched_;
+    const std::vector<Scalar>* bounds_{nullptr};
+
+    Heap<Vertex, HeapInterface> front_;
+};
+
 //! \brief Compute geodesic distance from a set of seed vertices
 //! \details The method works by a Dijkstra-like breadth first traversal from
 //! the seed vertices, implemented by a heap structure.
@@ -23,6 +151,7 @@ namespace pmp {
 //! \param[out] neighbors The vector of neighbor vertices.
 //! \return The number of neighbors that have been found.
 //! \pre Input mesh needs to be a triangle mesh.
+//! \note Use GeodesicSolver for repeated queries on the same mesh.
 //! \ingroup algorithms
 unsigned int geodesics(
     SurfaceMesh& mesh, const std::vector<Vertex>& seeds,
@@ -30,15 +159,103 @@ unsigned int geodesics(
     unsigned int maxnum = std::numeric_limits<unsigned int>::max(),
     std::vector<Vertex>* neighbors = nullptr);
 
+//! \brief Compute geodesic distances between two sets of vertices.
+//! \details Runs one fast-marching front per source vertex. Fronts are
+//! propagated in parallel if OpenMP is available, each thread using its own
+//! GeodesicSolver.
+//! \param mesh The input mesh.
+//! \param sources The source vertices.
+//! \param targets The target vertices.
+//! \param maxdist The maximum distance up to which to propagate each front.
+//! \return The matrix of distances from `sources[i]` (row `i`) to
+//! `targets[j]` (column `j`). Distances larger than \p maxdist are set to
+//! `std::numeric_limits<float>::max()`.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \note For distances based on the heat method, pass one seed set per source
+//! to HeatGeodesics::compute().
+//! \ingroup algorithms
+Eigen::MatrixXf geodesic_distance_matrix(
+    const SurfaceMesh& mesh, const std::vector<Vertex>& sources,
+    const std::vector<Vertex>& targets,
+    Scalar maxdist = std::numeric_limits<Scalar>::max());
+
+//! \brief Select evenly spaced vertices by geodesic farthest point sampling.
+//! \details Starting from the first vertex, iteratively selects the vertex
+//! farthest from all samples so far. The distances to the samples are updated
+//! incrementally by a fast-marching front from each new sample that stops
+//! where it no longer improves the distances.
+//! \param mesh The input mesh.
+//! \param n_samples The number of samples.
+//! \return The sample vertices in the order of selection.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \ingroup algorithms
+std::vector<Vertex> farthest_point_sampling(const SurfaceMesh& mesh,
+                                            unsigned int n_samples);
+
+//! \brief Select vertices with a minimum geodesic distance \p radius.
+//! \details Performs farthest point sampling until all vertices are closer
+//! than \p radius to a sample, resulting in a maximal Poisson disk sampling.
+//! \param mesh The input mesh.
+//! \param radius The minimum distance between samples.
+//! \return The sample vertices in the order of selection.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \ingroup algorithms
+std::vector<Vertex> poisson_disk_sampling(const SurfaceMesh& mesh,
+                                          Scalar radius);
+
 //! \brief Compute geodesic distance from a set of seed vertices
 //! \details Compute geodesic distances based on the heat method,
 //! by solving two Poisson systems. Works on general polygon meshes.
 //! See \cite crane_2013_geodesics for details.
 //! \param mesh The input mesh, modified in place.
 //! \param seeds The vector of seed vertices.
+//! \param solver The linear solver. The matrix-free conjugate gradient solver
+//! requires much less memory for large meshes, but requires a triangle mesh.
+//! LinearSolver::Multigrid is not supported for the semi-definite Poisson
+//! system, LinearSolver::MixedPrecision is not accurate enough for the
+//! exponentially decaying heat. Both fall back to Cholesky.
+//! \throw SolverException in case of failure to solve the linear systems.
+//! \throw InvalidInputException if the conjugate gradient solver is used on a
+//! mesh that is not a triangle mesh.
 //! \note This algorithm works on general polygon meshes.
+//! \note Use HeatGeodesics for repeated queries on the same mesh.
+//! \ingroup algorithms
+void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seeds,
+                    LinearSolver solver = LinearSolver::Cholesky);
+
+//! \brief Prefactored solver for geodesic distances based on the heat method.
+//! \details Sets up the gradient, divergence, and mass matrices and factorizes
+//! the heat diffusion and Poisson systems once. Each query then only requires
+//! back-substitutions and sparse matrix products. Multiple seed sets can be
+//! solved at once, one per column of the result.
+//! See \cite crane_2013_geodesics for details.
+//! \note This algorithm works on general polygon meshes. The mesh must not
+//! contain deleted elements.
 //! \ingroup algorithms
-void geodesics_heat(SurfaceMesh& mesh, const std::vector<Vertex>& seeds);
+class HeatGeodesics
+{
+public:
+    //! \brief Set up and factorize the linear systems for \p mesh.
+    //! \throw SolverException in case of failure to factorize the systems.
+    explicit HeatGeodesics(const SurfaceMesh& mesh);
+
+    //! \brief Compute geodesic distances from a set of seed vertices.
+    //! \return The distances, indexed by vertex index.
+    //! \throw SolverException in case of failure to solve the systems.
+    Eigen::VectorXd compute(const std::vector<Vertex>& seeds) const;
+
+    //! \brief Compute geodesic distances for several sets of seed vertices.
+    //! \return The distances, one column per seed set, rows indexed by vertex
+    //! index.
+    //! \throw SolverException in case of failure to solve the systems.
+    DenseMatrix compute(const std::vector<std::vector<Vertex>>& seeds) const;
+
+private:
+    SparseMatrix G_; // gradient
+    SparseMatrix D_; // divergence
+    Eigen::SimplicialLDLT<SparseMatrix> heat_solver_;
+    Eigen::SimplicialLDLT<SparseMatrix> poisson_solver_;
+};
 
 //! \brief Use the normalized distances as texture coordinates
 //! \details Stores the normalized distances in a vertex property of type
@@ -0,0 +1,200 @@
+// Copyright 2011-2020 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace pmp {
+
+//! \brief Indexed d-ary min-heap supporting key updates and removal.
+//! \details Heap entries are lightweight handles, e.g., vertices. Comparing
+//! entries and keeping track of their position in the heap is delegated to a
+//! \p HeapInterface, which has to provide the member functions
+//! `bool less(HeapEntry, HeapEntry)`, `bool greater(HeapEntry, HeapEntry)`,
+//! `int get_heap_position(HeapEntry)`, and
+//! `void set_heap_position(HeapEntry, int)`.
+//! Storing the heap positions, e.g., in a mesh property, allows to update or
+//! remove arbitrary entries in logarithmic time.
+//! \tparam Arity The number of children per heap node. Larger values result
+//! in shallower heaps with cheaper insertions and key decreases, at the cost of
+//! more comparisons when removing the front entry.
+//! \ingroup algorithms
+template <class HeapEntry, class HeapInterface, unsigned int Arity = 4>
+class Heap
+{
+    static_assert(Arity >= 2, "Heap needs at least two children per node");
+
+public:
+    //! Construct with a default \p HeapInterface
+    Heap() = default;
+
+    //! Construct with a given \p HeapInterface.
+    explicit Heap(const HeapInterface& i) : interface_(i) {}
+
+    //! clear the heap
+    void clear() { entries_.clear(); }
+
+    //! is heap empty?
+    bool empty() const { return entries_.empty(); }
+
+    //! returns the size of heap
+    unsigned int size() const { return (unsigned int)entries_.size(); }
+
+    //! reserve space for N entries
+    void reserve(unsigned int n) { entries_.reserve(n); }
+
+    //! reset heap position to -1 (not in heap)
+    void reset_heap_position(HeapEntry h)
+    {
+        interface_.set_heap_position(h, -1);
+    }
+
+    //! is an entry in the heap?
+    bool is_stored(HeapEntry h)
+    {
+        return interface_.get_heap_position(h) != -1;
+    }
+
+    //! insert the entry h
+    void insert(HeapEntry h)
+    {
+        entries_.push_back(h);
+        upheap(size() - 1);
+    }
+
+    //! get the first entry
+    HeapEntry front() const
+    {
+        assert(!empty());
+        return entries_[0];
+    }
+
+    //! delete the first entry
+    void pop_front()
+    {
+        assert(!empty());
+        interface_.set_heap_position(entries_[0], -1);
+        if (size() > 1)
+        {
+            entry(0, entries_.back());
+            entries_.pop_back();
+            downheap(0);
+        }
+        else
+            entries_.pop_back();
+    }
+
+    //! remove an entry
+    void remove(HeapEntry h)
+    {
+        const int pos = interface_.get_heap_position(h);
+        interface_.set_heap_position(h, -1);
+
+        assert(pos != -1);
+        assert((unsigned int)pos < size());
+
+        // last item ?
+        if ((unsigned int)pos == size() - 1)
+            entries_.pop_back();
+
+        else
+        {
+            entry(pos, entries_.back()); // move last elem to pos
+            entries_.pop_back();
+            downheap(pos);
+            upheap(pos);
+        }
+    }
+
+    //! update an entry: change the key and update the position to
+    //! reestablish the heap property.
+    void update(HeapEntry h)
+    {
+        const int pos = interface_.get_heap_position(h);
+        assert(pos != -1);
+        assert((unsigned int)pos < size());
+        downheap(pos);
+        upheap(pos);
+    }
+
+    //! Check heap condition. true if heap condition is satisfied, false if not.
+    bool check()
+    {
+        for (unsigned int i = 1; i < size(); ++i)
+        {
+            if (interface_.greater(entries_[parent(i)], entries_[i]))
+                return false;
+            if (interface_.get_heap_position(entries_[i]) != (int)i)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    // Upheap. Establish heap property.
+    void upheap(unsigned int idx)
+    {
+        HeapEntry h = entries_[idx];
+        unsigned int parent_idx;
+
+        while ((idx > 0) &&
+               interface_.less(h, entries_[parent_idx = parent(idx)]))
+        {
+            entry(idx, entries_[parent_idx]);
+            idx = parent_idx;
+        }
+
+        entry(idx, h);
+    }
+
+    // Downheap. Establish heap property.
+    void downheap(unsigned int idx)
+    {
+        HeapEntry h = entries_[idx];
+        const unsigned int s = size();
+
+        while (true)
+        {
+            const unsigned int first = child(idx);
+            if (first >= s)
+                break;
+
+            // find smallest child
+            const unsigned int last = std::min(first + Arity, s);
+            unsigned int child_idx = first;
+            for (unsigned int i = first + 1; i < last; ++i)
+                if (interface_.less(entries_[i], entries_[child_idx]))
+                    child_idx = i;
+
+            if (interface_.less(h, entries_[child_idx]))
+                break;
+
+            entry(idx, entries_[child_idx]);
+            idx = child_idx;
+        }
+
+        entry(idx, h);
+    }
+
+    // Set entry h to index idx and update h's heap position.
+    void entry(unsigned int idx, HeapEntry h)
+    {
+        assert(idx < size());
+        entries_[idx] = h;
+        interface_.set_heap_position(h, idx);
+    }
+
+    // Get parent's index
+    static unsigned int parent(unsigned int i) { return (i - 1) / Arity; }
+
+    // Get first child's index
+    static unsigned int child(unsigned int i) { return Arity * i + 1; }
+
+    std::vector<HeapEntry> entries_;
+    HeapInterface interface_;
+};
+
+} // namespace pmp
@@ -11,6 +11,7 @@
 
 #include "pmp/algorithms/fairing.h"
 #include "pmp/algorithms/normals.h"
+#include "pmp/algorithms/numerics.h"
 
 namespace pmp {
 namespace {
@@ -96,6 +97,10 @@ private:
 
     std::vector<Halfedge> hole_;
 
+    // reuses the symbolic factorization if relaxation() does not change
+    // the connectivity between iterations
+    SparseSolverCache relaxation_solver_;
+
     // data for computing optimal triangulation
     std::vector<std::vector<Weight>> weight_;
     std::vector<std::vector<int>> index_;
@@ -483,7 +488,6 @@ void HoleFilling::relaxation()
 
     // setup matrix & rhs
     Eigen::MatrixXd B(n, 3);
-    using Triplet = Eigen::Triplet<double>;
     std::vector<Triplet> triplets;
     for (int i = 0; i < n; ++i)
     {
@@ -509,18 +513,18 @@ void HoleFilling::relaxation()
     }
 
     // solve least squares system
-    using SparseMatrix = Eigen::SparseMatrix<double>;
     SparseMatrix A(n, n);
     A.setFromTriplets(triplets.begin(), triplets.end());
-    const Eigen::SimplicialLDLT<SparseMatrix> solver(A);
-    Eigen::MatrixXd X = solver.solve(B);
-
-    if (solver.info() != Eigen::Success)
+    Eigen::MatrixXd X;
+    try
+    {
+        X = relaxation_solver_.solve(A, B);
+    }
+    catch (const SolverException&)
     {
         // clean up
         mesh_.remove_vertex_property(idx);
-        auto what = std::string{__func__} + ": Failed to solve linear system.";
-        throw SolverException(what);
+        throw;
     }
 
     // copy solution to mesh vertices
@@ -4,6 +4,9 @@
 
 #include "pmp/algorithms/laplace.h"
 
+#include <algorithm>
+#include <numeric>
+
 // #define TFEM
 
 namespace pmp {
@@ -31,36 +34,96 @@ double triarea(const Eigen::Vector3d& p0, const Eigen::Vector3d& p1,
     return 0.5 * double_area;
 }
 
+// The local operators are templated on the number N of polygon vertices,
+// such that small polygons use fixed-size matrices without heap allocation.
+// N is Eigen::Dynamic for general polygons.
+
+// compile-time size N + k, or Eigen::Dynamic
+constexpr int add_size(int N, int k)
+{
+    return N == Eigen::Dynamic ? Eigen::Dynamic : N + k;
+}
+
+// compile-time size N * k, or Eigen::Dynamic
+constexpr int mul_size(int N, int k)
+{
+    return N == Eigen::Dynamic ? Eigen::Dynamic : N * k;
+}
+
+// positions of polygon vertices, one per row
+template <int N>
+using Polygon = Eigen::Matrix<double, N, 3>;
+
+template <int N>
+using PolygonVector = Eigen::Matrix<double, N, 1>;
+
+template <int N>
+using PolygonMatrix = Eigen::Matrix<double, N, N>;
+
+template <int N>
+using GradientMatrix = Eigen::Matrix<double, mul_size(N, 3), N>;
+
+// maximum number of polygon vertices with fixed-size local operators
+constexpr int max_fixed_size = 6;
+
+// call f.template operator()<N>() for a polygon with n vertices, with N = n
+// for small polygons and N = Eigen::Dynamic for larger ones
+template <typename Function>
+void with_polygon_size(int n, Function&& f)
+{
+    switch (n)
+    {
+        case 3:
+            f.template operator()<3>();
+            break;
+        case 4:
+            f.template operator()<4>();
+            break;
+        case 5:
+            f.template operator()<5>();
+            break;
+        case max_fixed_size:
+            f.template operator()<max_fixed_size>();
+            break;
+        default:
+            f.template operator()<Eigen::Dynamic>();
+    }
+}
+
 // compute virtual vertex per polygon, represented by affine weights,
 // such that the resulting triangle fan minimizes the sum of squared triangle areas
-void compute_virtual_vertex(const DenseMatrix& poly, Eigen::VectorXd& weights)
+template <int N>
+void compute_virtual_vertex(const Polygon<N>& poly, PolygonVector<N>& weights)
 {
     const int n = poly.rows();
 
-    // setup array of positions and edges
-    std::vector<dvec3> x(n), d(n);
-    for (int i = 0; i < n; ++i)
-        x[i] = poly.row(i);
-    for (int i = 0; i < n; ++i)
-        d[i] = x[(i + 1) % n] - x[i];
+    // cross products of positions and edges, C.col(i * n + k) = x_i x d_k
+    Eigen::Matrix<double, 3, mul_size(N, N)> C(3, n * n);
+    for (int k = 0; k < n; ++k)
+    {
+        const Eigen::Vector3d d = poly.row((k + 1) % n) - poly.row(k);
+        for (int i = 0; i < n; ++i)
+            C.col(i * n + k) = poly.row(i).transpose().cross(d);
+    }
 
     // setup matrix A and rhs b
     // see Equation (38) of "Polygon Laplacian made simple", Eurographics 2020
-    DenseMatrix A(n + 1, n);
-    Eigen::VectorXd b(n + 1);
+    Eigen::Matrix<double, add_size(N, 1), N> A(n + 1, n);
+    PolygonVector<add_size(N, 1)> b(n + 1);
     for (int j = 0; j < n; ++j)
     {
         for (int i = j; i < n; ++i)
         {
-            double Aij(0.0), bi(0.0);
+            double Aij(0.0);
             for (int k = 0; k < n; ++k)
-            {
-                Aij += dot(cross(x[j], d[k]), cross(x[i], d[k]));
-                bi += dot(cross(x[i], d[k]), cross(x[k], d[k]));
-            }
+                Aij += C.col(j * n + k).dot(C.col(i * n + k));
             A(i, j) = A(j, i) = Aij;
-            b(i) = bi;
         }
+
+        double bj(0.0);
+        for (int k = 0; k < n; ++k)
+            bj += C.col(j * n + k).dot(C.col(k * n + k));
+        b(j) = bj;
     }
     for (int j = 0; j < n; ++j)
     {
@@ -72,7 +135,7 @@ void compute_virtual_vertex(const DenseMatrix& poly, Eigen::VectorXd& weights)
 }
 
 void triangle_mass_matrix(const Eigen::Vector3d& p0, const Eigen::Vector3d& p1,
-                          const Eigen::Vector3d& p2, DiagonalMatrix& Mtri)
+                          const Eigen::Vector3d& p2, Eigen::Vector3d& Mtri)
 {
     // three vertex positions
     const std::array<dvec3, 3> p = {p0, p1, p2};
@@ -90,7 +153,7 @@ void triangle_mass_matrix(const Eigen::Vector3d& p0, const Eigen::Vector3d& p1,
 #endif
     if (tri_area <= std::numeric_limits<double>::min())
     {
-        Mtri.setZero(3);
+        Mtri.setZero();
         return;
     }
 
@@ -105,7 +168,7 @@ void triangle_mass_matrix(const Eigen::Vector3d& p0, const Eigen::Vector3d& p1,
         cot[i] = d[i] / tri_area;
 
     // compute area for each corner
-    Eigen::Vector3d area;
+    auto& area = Mtri;
     for (int i = 0; i < 3; ++i)
     {
         // angle at corner is obtuse
@@ -125,15 +188,15 @@ void triangle_mass_matrix(const Eigen::Vector3d& p0, const Eigen::Vector3d& p1,
                                sqrnorm(e[(i + 2) % 3]) * cot[(i + 1) % 3]);
         }
     }
-    Mtri = area.asDiagonal();
 }
 
-void polygon_mass_matrix(const DenseMatrix& polygon, DiagonalMatrix& Mpoly)
+template <int N>
+void polygon_mass_matrix(const Polygon<N>& polygon, PolygonVector<N>& Mpoly)
 {
     const int n = (int)polygon.rows();
 
     // shortcut for triangles
-    if (n == 3)
+    if constexpr (N == 3)
     {
         triangle_mass_matrix(polygon.row(0), polygon.row(1), polygon.row(2),
                              Mpoly);
@@ -141,13 +204,14 @@ void polygon_mass_matrix(const DenseMatrix& polygon, DiagonalMatrix& Mpoly)
     }
 
     // compute position of virtual vertex
-    Eigen::VectorXd vweights;
-    compute_virtual_vertex(polygon, vweights);
+    PolygonVector<N> vweights;
+    compute_virtual_vertex<N>(polygon, vweights);
     const Eigen::Vector3d vvertex = polygon.transpose() * vweights;
 
     // laplace matrix of refined triangle fan
-    DenseMatrix Mfan = DenseMatrix::Zero(n + 1, n + 1);
-    DiagonalMatrix Mtri;
+    PolygonMatrix<add_size(N, 1)> Mfan =
+        PolygonMatrix<add_size(N, 1)>::Zero(n + 1, n + 1);
+    Eigen::Vector3d Mtri;
     for (int i = 0; i < n; ++i)
     {
         const int j = (i + 1) % n;
@@ -157,24 +221,24 @@ void polygon_mass_matrix(const DenseMatrix& polygon, DiagonalMatrix& Mpoly)
 
         // assemble to laplace matrix for refined triangle fan
         // (we are dealing with diagonal matrices)
-        Mfan.diagonal()[i] += Mtri.diagonal()[0];
-        Mfan.diagonal()[j] += Mtri.diagonal()[1];
-        Mfan.diagonal()[n] += Mtri.diagonal()[2];
+        Mfan.diagonal()[i] += Mtri[0];
+        Mfan.diagonal()[j] += Mtri[1];
+        Mfan.diagonal()[n] += Mtri[2];
     }
 
     // build prolongation matrix
-    DenseMatrix P(n + 1, n);
+    Eigen::Matrix<double, add_size(N, 1), N> P(n + 1, n);
     P.setIdentity();
     P.row(n) = vweights;
 
     // build polygon laplace matrix by sandwiching
-    DenseMatrix PMP = P.transpose() * Mfan * P;
-    Mpoly = PMP.rowwise().sum().asDiagonal();
+    const PolygonMatrix<N> PMP = P.transpose() * Mfan * P;
+    Mpoly = PMP.rowwise().sum();
 }
 
 void triangle_laplace_matrix(const Eigen::Vector3d& p0,
                              const Eigen::Vector3d& p1,
-                             const Eigen::Vector3d& p2, DenseMatrix& Ltri)
+                             const Eigen::Vector3d& p2, Eigen::Matrix3d& Ltri)
 {
 #ifndef TFEM
     std::array<double, 3> l, l2, cot;
@@ -243,13 +307,14 @@ void triangle_laplace_matrix(const Eigen::Vector3d& p0,
 #endif
 }
 
-void polygon_laplace_matrix(const DenseMatrix& polygon, DenseMatrix& Lpoly)
+template <int N>
+void polygon_laplace_matrix(const Polygon<N>& polygon, PolygonMatrix<N>& Lpoly)
 {
     const int n = (int)polygon.rows();
-    Lpoly = DenseMatrix::Zero(n, n);
+    Lpoly = PolygonMatrix<N>::Zero(n, n);
 
     // shortcut for triangles
-    if (n == 3)
+    if constexpr (N == 3)
     {
         triangle_laplace_matrix(polygon.row(0), polygon.row(1), polygon.row(2),
                                 Lpoly);
@@ -257,13 +322,14 @@ void polygon_laplace_matrix(const DenseMatrix& polygon, DenseMatrix& Lpoly)
     }
 
     // compute position of virtual vertex
-    Eigen::VectorXd vweights;
-    compute_virtual_vertex(polygon, vweights);
+    PolygonVector<N> vweights;
+    compute_virtual_vertex<N>(polygon, vweights);
     const Eigen::Vector3d vvertex = polygon.transpose() * vweights;
 
     // laplace matrix of refined triangle fan
-    DenseMatrix Lfan = DenseMatrix::Zero(n + 1, n + 1);
-    DenseMatrix Ltri(3, 3);
+    PolygonMatrix<add_size(N, 1)> Lfan =
+        PolygonMatrix<add_size(N, 1)>::Zero(n + 1, n + 1);
+    Eigen::Matrix3d Ltri;
     for (int i = 0; i < n; ++i)
     {
         const int j = (i + 1) % n;
@@ -284,7 +350,7 @@ void polygon_laplace_matrix(const DenseMatrix& polygon, DenseMatrix& Lpoly)
     }
 
     // build prolongation matrix
-    DenseMatrix P(n + 1, n);
+    Eigen::Matrix<double, add_size(N, 1), N> P(n + 1, n);
     P.setIdentity();
     P.row(n) = vweights;
 
@@ -294,9 +360,8 @@ void polygon_laplace_matrix(const DenseMatrix& polygon, DenseMatrix& Lpoly)
 
 void triangle_gradient_matrix(const Eigen::Vector3d& p0,
                               const Eigen::Vector3d& p1,
-                              const Eigen::Vector3d& p2, DenseMatrix& G)
+                              const Eigen::Vector3d& p2, Eigen::Matrix3d& G)
 {
-    G.resize(3, 3);
     Eigen::Vector3d n = (p1 - p0).cross(p2 - p0);
 #ifndef TFEM
     const double double_area = n.norm();
@@ -317,17 +382,21 @@ void triangle_gradient_matrix(const Eigen::Vector3d& p0,
     }
 }
 
-void polygon_gradient_matrix(const DenseMatrix& polygon, DenseMatrix& Gpoly)
+template <int N>
+void polygon_gradient_matrix(const Polygon<N>& polygon,
+                             GradientMatrix<N>& Gpoly)
 {
     const int n = (int)polygon.rows();
 
     // compute position of virtual vertex
-    Eigen::VectorXd vweights;
-    compute_virtual_vertex(polygon, vweights);
+    PolygonVector<N> vweights;
+    compute_virtual_vertex<N>(polygon, vweights);
     const Eigen::Vector3d vvertex = polygon.transpose() * vweights;
 
-    DenseMatrix Gfan = DenseMatrix::Zero(3 * n, n + 1);
-    DenseMatrix Gtri(3, 3);
+    Eigen::Matrix<double, mul_size(N, 3), add_size(N, 1)> Gfan =
+        Eigen::Matrix<double, mul_size(N, 3), add_size(N, 1)>::Zero(3 * n,
+                                                                     n + 1);
+    Eigen::Matrix3d Gtri;
     int row = 0;
     for (int i = 0; i < n; ++i)
     {
@@ -348,7 +417,7 @@ void polygon_gradient_matrix(const DenseMatrix& polygon, DenseMatrix& Gpoly)
     }
 
     // build prolongation matrix
-    DenseMatrix P(n + 1, n);
+    Eigen::Matrix<double, add_size(N, 1), N> P(n + 1, n);
     P.setIdentity();
     P.row(n) = vweights;
 
@@ -356,58 +425,220 @@ void polygon_gradient_matrix(const DenseMatrix& polygon, DenseMatrix& Gpoly)
     Gpoly = Gfan * P;
 }
 
-void divmass_matrix(const SurfaceMesh& mesh, DiagonalMatrix& M)
+// offsets of per-face data with size(valence) entries per face, indexed by
+// face index. deleted faces have no entries.
+template <typename Size>
+std::vector<size_t> face_offsets(const SurfaceMesh& mesh, Size size)
 {
-    // how many virtual triangles will we have after refinement?
-    unsigned int nt = 0;
-    for (auto f : mesh.faces())
+    std::vector<size_t> offsets(mesh.faces_size() + 1, 0);
+    for (size_t i = 0; i < mesh.faces_size(); ++i)
     {
-        nt += mesh.valence(f);
+        const Face f(i);
+        offsets[i + 1] = offsets[i];
+        if (!mesh.is_deleted(f))
+            offsets[i + 1] += size(mesh.valence(f));
     }
+    return offsets;
+}
 
-    // initialize global matrix
-    M.resize(3 * nt);
-    auto& diag = M.diagonal();
+// collect polygon vertices
+void collect_vertices(const SurfaceMesh& mesh, Face f,
+                      std::vector<Vertex>& vertices)
+{
+    vertices.clear();
+    for (const auto v : mesh.vertices(f))
+        vertices.push_back(v);
+}
 
-    std::vector<Vertex> vertices; // polygon vertices
-    DenseMatrix polygon;          // positions of polygon vertices
+// collect positions of polygon vertices
+template <int N>
+Polygon<N> collect_positions(const SurfaceMesh& mesh,
+                             const std::vector<Vertex>& vertices)
+{
+    const int n = vertices.size();
+    Polygon<N> polygon(n, 3);
+    for (int i = 0; i < n; ++i)
+        polygon.row(i) = (Eigen::Vector3d)mesh.position(vertices[i]);
+    return polygon;
+}
+
+// assemble a square matrix column by column in parallel. column(j, entries)
+// appends at most max_sizes[j] unsorted entries of column j, which are
+// merged per column, such that no global sort of triplets is needed.
+template <typename Column>
+void assemble_columns(const Eigen::VectorXi& max_sizes, Column column,
+                      SparseMatrix& A)
+{
+    const int n = max_sizes.size();
+    A.resize(n, n);
+    if (max_sizes.sum() == 0)
+        return;
+    A.reserve(max_sizes);
 
-    unsigned int idx = 0;
+    const auto* outer = A.outerIndexPtr();
+    auto* inner = A.innerIndexPtr();
+    auto* values = A.valuePtr();
+    auto* sizes = A.innerNonZeroPtr();
 
-    for (const auto f : mesh.faces())
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-        // collect polygon vertices
-        vertices.clear();
-        for (const auto v : mesh.vertices(f))
+        std::vector<std::pair<int, double>> entries;
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int j = 0; j < n; ++j)
         {
-            vertices.push_back(v);
+            entries.clear();
+            column(j, entries);
+            assert(entries.size() <= size_t(max_sizes[j]));
+            std::sort(entries.begin(), entries.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.first < b.first;
+                      });
+
+            int k = outer[j];
+            for (const auto& [i, a] : entries)
+            {
+                if (k > outer[j] && inner[k - 1] == i)
+                {
+                    values[k - 1] += a;
+                }
+                else
+                {
+                    inner[k] = i;
+                    values[k] = a;
+                    ++k;
+                }
+            }
+            sizes[j] = k - outer[j];
         }
-        const int n = vertices.size();
+    }
 
-        // collect their positions
-        polygon.resize(n, 3);
-        for (int i = 0; i < n; ++i)
+    A.makeCompressed();
+}
+
+// build the gradient matrix in row-major order, where each face owns a
+// contiguous block of rows
+void gradient_rows(const SurfaceMesh& mesh,
+                   Eigen::SparseMatrix<double, Eigen::RowMajor>& G)
+{
+    const int nf = mesh.faces_size();
+
+    // each face has three rows per virtual triangle after refinement,
+    // with one entry per polygon vertex in each row
+    const auto rows = face_offsets(mesh, [](size_t n) { return 3 * n; });
+    const auto nonzeros =
+        face_offsets(mesh, [](size_t n) { return 3 * n * n; });
+
+    G.resize(rows.back(), mesh.n_vertices());
+    G.resizeNonZeros(nonzeros.back());
+    auto* outer = G.outerIndexPtr();
+    auto* inner = G.innerIndexPtr();
+    auto* values = G.valuePtr();
+    outer[rows.back()] = nonzeros.back();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<Vertex> vertices; // polygon vertices
+        std::vector<int> order;       // vertices sorted by index
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int i = 0; i < nf; ++i)
         {
-            polygon.row(i) = (Eigen::Vector3d)mesh.position(vertices[i]);
+            const Face f(i);
+            if (mesh.is_deleted(f))
+                continue;
+
+            collect_vertices(mesh, f, vertices);
+            const int n = vertices.size();
+
+            // column indices of each row have to be sorted
+            order.resize(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&](int a, int b) {
+                return vertices[a].idx() < vertices[b].idx();
+            });
+
+            with_polygon_size(n, [&]<int N>() {
+                // setup local element matrix
+                GradientMatrix<N> Gpoly;
+                polygon_gradient_matrix<N>(
+                    collect_positions<N>(mesh, vertices), Gpoly);
+
+                // copy to this face's block of rows
+                size_t k = nonzeros[i];
+                for (int r = 0; r < Gpoly.rows(); ++r)
+                {
+                    outer[rows[i] + r] = k;
+                    for (int j : order)
+                    {
+                        inner[k] = vertices[j].idx();
+                        values[k] = Gpoly(r, j);
+                        ++k;
+                    }
+                }
+            });
         }
+    }
+}
 
-        // compute position of virtual vertex
-        Eigen::VectorXd vweights;
-        compute_virtual_vertex(polygon, vweights);
-        const Eigen::Vector3d vvertex = polygon.transpose() * vweights;
+void divmass_matrix(const SurfaceMesh& mesh, DiagonalMatrix& M)
+{
+    const int nf = mesh.faces_size();
 
-        for (int i = 0; i < n; ++i)
+    // three entries per virtual triangle after refinement
+    const auto offsets = face_offsets(mesh, [](size_t n) { return 3 * n; });
+
+    // initialize global matrix
+    M.resize(offsets.back());
+    auto& diag = M.diagonal();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<Vertex> vertices; // polygon vertices
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int i = 0; i < nf; ++i)
         {
-            const double area =
-                triarea(polygon.row(i), polygon.row((i + 1) % n), vvertex);
+            const Face f(i);
+            if (mesh.is_deleted(f))
+                continue;
+
+            collect_vertices(mesh, f, vertices);
+            const int n = vertices.size();
 
-            diag[idx++] = area;
-            diag[idx++] = area;
-            diag[idx++] = area;
+            with_polygon_size(n, [&]<int N>() {
+                const auto polygon = collect_positions<N>(mesh, vertices);
+
+                // compute position of virtual vertex
+                PolygonVector<N> vweights;
+                compute_virtual_vertex<N>(polygon, vweights);
+                const Eigen::Vector3d vvertex = polygon.transpose() * vweights;
+
+                size_t idx = offsets[i];
+                for (int j = 0; j < n; ++j)
+                {
+                    const double area = triarea(
+                        polygon.row(j), polygon.row((j + 1) % n), vvertex);
+
+                    diag[idx++] = area;
+                    diag[idx++] = area;
+                    diag[idx++] = area;
+                }
+            });
         }
     }
-
-    assert(idx == 3 * nt);
 }
 
 } // anonymous namespace
@@ -424,36 +655,56 @@ void uniform_mass_matrix(const SurfaceMesh& mesh, DiagonalMatrix& M)
 void mass_matrix(const SurfaceMesh& mesh, DiagonalMatrix& M)
 {
     const int nv = mesh.n_vertices();
-    std::vector<Vertex> vertices; // polygon vertices
-    DenseMatrix polygon;          // positions of polygon vertices
-    DiagonalMatrix Mpoly;         // local mass matrix
+    const int nf = mesh.faces_size();
 
-    M.setZero(nv);
+    // local mass of each polygon corner, stored at the halfedge pointing to
+    // the corner's vertex
+    std::vector<double> corner_mass(mesh.halfedges_size(), 0.0);
 
-    for (const auto f : mesh.faces())
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-        // collect polygon vertices
-        vertices.clear();
-        for (const auto v : mesh.vertices(f))
-        {
-            vertices.push_back(v);
-        }
-        const int n = vertices.size();
+        std::vector<Vertex> vertices; // polygon vertices
 
-        // collect their positions
-        polygon.resize(n, 3);
-        for (int i = 0; i < n; ++i)
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int i = 0; i < nf; ++i)
         {
-            polygon.row(i) = (Eigen::Vector3d)mesh.position(vertices[i]);
+            const Face f(i);
+            if (mesh.is_deleted(f))
+                continue;
+
+            collect_vertices(mesh, f, vertices);
+
+            with_polygon_size(vertices.size(), [&]<int N>() {
+                // setup local mass matrix
+                PolygonVector<N> Mpoly;
+                polygon_mass_matrix<N>(collect_positions<N>(mesh, vertices),
+                                       Mpoly);
+
+                // vertices(f) enumerates the targets of halfedges(f)
+                int k = 0;
+                for (const auto h : mesh.halfedges(f))
+                    corner_mass[h.idx()] = Mpoly[k++];
+            });
         }
+    }
 
-        // setup local mass matrix
-        polygon_mass_matrix(polygon, Mpoly);
+    // assemble to global mass matrix, gathering the corners of each vertex
+    M.setZero(nv);
+    auto& diag = M.diagonal();
 
-        // assemble to global mass matrix
-        for (int k = 0; k < n; ++k)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < nv; ++i)
+    {
+        for (const auto h : mesh.halfedges(Vertex(i)))
         {
-            M.diagonal()[vertices[k].idx()] += Mpoly.diagonal()[k];
+            if (!mesh.is_boundary(h))
+                diag[i] += corner_mass[mesh.prev_halfedge(h).idx()];
         }
     }
 }
@@ -462,69 +713,101 @@ void uniform_laplace_matrix(const SurfaceMesh& mesh, SparseMatrix& L)
 {
     const unsigned int n = mesh.n_vertices();
 
-    std::vector<Triplet> triplets;
-    triplets.reserve(8 * n); // conservative estimate for triangle meshes
+    // one entry per neighbor and one on the diagonal
+    Eigen::VectorXi sizes(n);
+    for (auto v : mesh.vertices())
+        sizes[v.idx()] = mesh.valence(v) + 1;
 
-    for (auto vi : mesh.vertices())
-    {
-        Scalar sum_weights = 0.0;
-        for (auto vj : mesh.vertices(vi))
+    auto column = [&](int j, std::vector<std::pair<int, double>>& entries) {
+        double sum_weights = 0.0;
+        for (auto vi : mesh.vertices(Vertex(j)))
         {
             sum_weights += 1.0;
-            triplets.emplace_back(vi.idx(), vj.idx(), 1.0);
+            entries.emplace_back(vi.idx(), 1.0);
         }
-        triplets.emplace_back(vi.idx(), vi.idx(), -sum_weights);
-    }
+        entries.emplace_back(j, -sum_weights);
+    };
 
-    L.resize(n, n);
-    L.setFromTriplets(triplets.begin(), triplets.end());
+    assemble_columns(sizes, column, L);
 }
 
 void laplace_matrix(const SurfaceMesh& mesh, SparseMatrix& L, bool clamp)
 {
     const int nv = mesh.n_vertices();
-    const int nf = mesh.n_faces();
-    std::vector<Vertex> vertices; // polygon vertices
-    DenseMatrix polygon;          // positions of polygon vertices
-    DenseMatrix Lpoly;            // local laplace matrix
+    const int nf = mesh.faces_size();
 
-    std::vector<Triplet> triplets;
-    triplets.reserve(9 * nf); // estimate for triangle meshes
+    // local laplace matrices, stored row-major per face, with rows and
+    // columns in the order of halfedges(f)
+    const auto offsets = face_offsets(mesh, [](size_t n) { return n * n; });
+    std::vector<double> local(offsets.back());
 
-    for (const auto f : mesh.faces())
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-        // collect polygon vertices
-        vertices.clear();
-        for (const auto v : mesh.vertices(f))
-        {
-            vertices.push_back(v);
-        }
-        const int n = vertices.size();
+        std::vector<Vertex> vertices; // polygon vertices
 
-        // collect their positions
-        polygon.resize(n, 3);
-        for (int i = 0; i < n; ++i)
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int i = 0; i < nf; ++i)
         {
-            polygon.row(i) = (Eigen::Vector3d)mesh.position(vertices[i]);
+            const Face f(i);
+            if (mesh.is_deleted(f))
+                continue;
+
+            collect_vertices(mesh, f, vertices);
+            const int n = vertices.size();
+
+            with_polygon_size(n, [&]<int N>() {
+                // setup local laplace matrix
+                PolygonMatrix<N> Lpoly;
+                polygon_laplace_matrix<N>(collect_positions<N>(mesh, vertices),
+                                          Lpoly);
+
+                Eigen::Map<Eigen::Matrix<double, N, N, Eigen::RowMajor>> Lf(
+                    local.data() + offsets[i], n, n);
+                Lf = Lpoly;
+            });
         }
+    }
 
-        // setup local laplace matrix
-        polygon_laplace_matrix(polygon, Lpoly);
+    // each column gathers the local matrices of the vertex' faces
+    Eigen::VectorXi sizes = Eigen::VectorXi::Zero(nv);
+    for (auto v : mesh.vertices())
+        for (auto h : mesh.halfedges(v))
+            if (!mesh.is_boundary(h))
+                sizes[v.idx()] += mesh.valence(mesh.face(h));
 
-        // assemble to global laplace matrix
-        for (int j = 0; j < n; ++j)
+    auto column = [&](int j, std::vector<std::pair<int, double>>& entries) {
+        const Vertex v(j);
+        for (auto h : mesh.halfedges(v))
         {
-            for (int k = 0; k < n; ++k)
+            if (mesh.is_boundary(h))
+                continue;
+
+            const Face f = mesh.face(h);
+            const double* Lf = local.data() + offsets[f.idx()];
+            const int n = mesh.valence(f);
+
+            // local index of v
+            int jj = 0;
+            for (auto hh : mesh.halfedges(f))
             {
-                triplets.emplace_back(vertices[k].idx(), vertices[j].idx(),
-                                      -Lpoly(k, j));
+                if (mesh.to_vertex(hh) == v)
+                    break;
+                ++jj;
             }
+
+            int k = 0;
+            for (auto hh : mesh.halfedges(f))
+                entries.emplace_back(mesh.to_vertex(hh).idx(),
+                                     -Lf[k++ * n + jj]);
         }
-    }
+    };
 
-    // build sparse matrix from triplets
-    L.resize(nv, nv);
-    L.setFromTriplets(triplets.begin(), triplets.end());
+    // build sparse matrix from local matrices
+    assemble_columns(sizes, column, L);
 
     // clamp negative off-diagonal entries to zero
     if (clamp)
@@ -550,73 +833,140 @@ void laplace_matrix(const SurfaceMesh& mesh, SparseMatrix& L, bool clamp)
     }
 }
 
-void gradient_matrix(const SurfaceMesh& mesh, SparseMatrix& G)
+void vertex_laplace(const SurfaceMesh& mesh, Vertex v, dvec3& laplace,
+                    double& mass)
 {
-    const int nv = mesh.n_vertices();
+    laplace = dvec3(0.0);
+    mass = 0.0;
 
-    // how many virtual triangles will we have after refinement?
-    // triangles are not refined, other polygons are.
-    unsigned int nt = 0;
-    for (auto f : mesh.faces())
+    std::vector<Vertex> vertices; // polygon vertices
+    for (auto h : mesh.halfedges(v))
     {
-        nt += mesh.valence(f);
+        if (mesh.is_boundary(h))
+            continue;
+
+        collect_vertices(mesh, mesh.face(h), vertices);
+        const int j = std::ranges::find(vertices, v) - vertices.begin();
+
+        with_polygon_size(vertices.size(), [&]<int N>() {
+            // setup local operators
+            const auto polygon = collect_positions<N>(mesh, vertices);
+            PolygonMatrix<N> Lpoly;
+            polygon_laplace_matrix<N>(polygon, Lpoly);
+            PolygonVector<N> Mpoly;
+            polygon_mass_matrix<N>(polygon, Mpoly);
+
+            // the global matrix accumulates the negated local matrices
+            laplace -= dvec3(polygon.transpose() * Lpoly.col(j));
+            mass += Mpoly[j];
+        });
     }
+}
 
-    std::vector<Vertex> vertices; // polygon vertices
-    DenseMatrix polygon;          // positions of polygon vertices
-    DenseMatrix Gpoly;            // local gradient matrix
-
-    std::vector<Triplet> triplets;
-    triplets.reserve(9 * nt);
+LaplaceOperator::LaplaceOperator(const SurfaceMesh& mesh,
+                                 bool use_uniform_weights, bool clamp)
+    : mesh_(mesh), weights_(mesh.edges_size(), use_uniform_weights ? 1.0 : 0.0)
+{
+    if (use_uniform_weights)
+        return;
 
-    unsigned int n_rows = 0;
+    if (!mesh.is_triangle_mesh())
+    {
+        auto what = std::string{__func__} +
+                    ": Cotan weights require a triangle mesh.";
+        throw InvalidInputException(what);
+    }
 
+    Eigen::Matrix3d Ltri;
     for (const auto f : mesh.faces())
     {
-        // collect polygon vertices
-        vertices.clear();
-        for (const auto v : mesh.vertices(f))
-        {
-            vertices.push_back(v);
-        }
-        const int n = vertices.size();
+        std::array<Halfedge, 3> h;
+        h[0] = mesh.halfedge(f);
+        h[1] = mesh.next_halfedge(h[0]);
+        h[2] = mesh.next_halfedge(h[1]);
 
-        // collect their positions
-        polygon.resize(n, 3);
-        for (int i = 0; i < n; ++i)
-        {
-            polygon.row(i) = (Eigen::Vector3d)mesh.position(vertices[i]);
-        }
+        // halfedge h[k] points from vertex k to vertex k+1
+        std::array<Eigen::Vector3d, 3> p;
+        for (int k = 0; k < 3; ++k)
+            p[k] = (Eigen::Vector3d)mesh.position(mesh.from_vertex(h[k]));
+
+        Ltri.setZero();
+        triangle_laplace_matrix(p[0], p[1], p[2], Ltri);
+
+        for (int k = 0; k < 3; ++k)
+            weights_[mesh.edge(h[k]).idx()] -= Ltri(k, (k + 1) % 3);
+    }
+
+    // clamp negative weights to zero
+    if (clamp)
+        for (auto& w : weights_)
+            w = std::max(w, 0.0);
+}
 
-        // setup local element matrix
-        polygon_gradient_matrix(polygon, Gpoly);
+void LaplaceOperator::multiply(const DenseMatrix& X, DenseMatrix& Y) const
+{
+    const int n = mesh_.n_vertices();
+    const Eigen::Index m = X.cols();
+    Y.resize(n, m);
+
+    // process up to four columns per traversal of the one-ring
+    constexpr Eigen::Index block = 4;
 
-        // assemble to global matrix
-        for (int j = 0; j < Gpoly.cols(); ++j)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < n; ++i)
+    {
+        for (Eigen::Index c0 = 0; c0 < m; c0 += block)
         {
-            for (int i = 0; i < Gpoly.rows(); ++i)
+            const Eigen::Index nc = std::min(block, m - c0);
+            std::array<double, block> sum{};
+            for (auto h : mesh_.halfedges(Vertex(i)))
             {
-                triplets.emplace_back(n_rows + i, vertices[j].idx(),
-                                      Gpoly(i, j));
+                const int j = mesh_.to_vertex(h).idx();
+                const double w = weights_[mesh_.edge(h).idx()];
+                for (Eigen::Index c = 0; c < nc; ++c)
+                    sum[c] += w * (X(j, c0 + c) - X(i, c0 + c));
             }
+            for (Eigen::Index c = 0; c < nc; ++c)
+                Y(i, c0 + c) = sum[c];
         }
-
-        n_rows += Gpoly.rows();
     }
-    assert(n_rows == 3 * nt);
+}
 
-    // build sparse matrix from triplets
-    G.resize(n_rows, nv);
-    G.setFromTriplets(triplets.begin(), triplets.end());
+Eigen::VectorXd LaplaceOperator::diagonal() const
+{
+    Eigen::VectorXd diag = Eigen::VectorXd::Zero(mesh_.n_vertices());
+    for (auto v : mesh_.vertices())
+        for (auto h : mesh_.halfedges(v))
+            diag[v.idx()] -= weights_[mesh_.edge(h).idx()];
+    return diag;
+}
+
+void gradient_matrix(const SurfaceMesh& mesh, SparseMatrix& G)
+{
+    Eigen::SparseMatrix<double, Eigen::RowMajor> Grows;
+    gradient_rows(mesh, Grows);
+    G = Grows;
 }
 
 void divergence_matrix(const SurfaceMesh& mesh, SparseMatrix& D)
 {
-    SparseMatrix G;
-    gradient_matrix(mesh, G);
+    // the transpose of the row-major gradient is column-major, such that
+    // -G^T * M is a copy with scaled columns
+    Eigen::SparseMatrix<double, Eigen::RowMajor> G;
+    gradient_rows(mesh, G);
     DiagonalMatrix M;
     divmass_matrix(mesh, M);
-    D = -G.transpose() * M;
+    D = G.transpose();
+
+    const int n = D.outerSize();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int k = 0; k < n; ++k)
+        for (SparseMatrix::InnerIterator iter(D, k); iter; ++iter)
+            iter.valueRef() *= -M.diagonal()[k];
 }
 
 } // namespace pmp
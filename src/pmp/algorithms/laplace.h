@@ -48,6 +48,22 @@ void mass_matrix(const SurfaceMesh& mesh, DiagonalMatrix& M);
 void laplace_matrix(const SurfaceMesh& mesh, SparseMatrix& L,
                     bool clamp = false);
 
+//! \brief Evaluate the cotan Laplacian and the mass of a single vertex.
+//! \details Computes the row of laplace_matrix() for vertex \p v applied to
+//! the vertex positions and the diagonal entry of mass_matrix() for \p v
+//! from the local operators of the faces incident to \p v only. The cost is
+//! independent of the mesh size, which allows updating quantities derived
+//! from the Laplacian after local changes of the vertex positions.
+//! \param mesh The input mesh.
+//! \param v The vertex.
+//! \param laplace The Laplacian of the vertex positions at \p v.
+//! \param mass The mass of \p v.
+//! \sa laplace_matrix
+//! \sa mass_matrix
+//! \ingroup algorithms
+void vertex_laplace(const SurfaceMesh& mesh, Vertex v, dvec3& laplace,
+                    double& mass);
+
 //! \brief Construct the cotan gradient matrix.
 //! \details Matrix is sparse and maps values at vertices to constant gradient 3D-vectors at non-boundary halfedges.
 //! The discrete operators are consistent, such that Laplacian is divergence of gradient.
@@ -70,4 +86,43 @@ void gradient_matrix(const SurfaceMesh& mesh, SparseMatrix& G);
 //! \ingroup algorithms
 void divergence_matrix(const SurfaceMesh& mesh, SparseMatrix& D);
 
+//! \brief Matrix-free cotan or uniform Laplace operator.
+//! \details Stores one weight per edge and computes products with the Laplace
+//! matrix directly from the mesh connectivity, in parallel if OpenMP is
+//! available. Requires memory linear in the number of edges, without the
+//! overhead of an assembled sparse matrix. The cotan weights are identical to
+//! the off-diagonal entries of laplace_matrix().
+//! The operator keeps a reference to the mesh, whose connectivity must not
+//! be modified as long as the operator is in use.
+//! \note The mesh must not contain deleted elements.
+//! \sa laplace_matrix
+//! \ingroup algorithms
+class LaplaceOperator
+{
+public:
+    //! \brief Compute the edge weights.
+    //! \param mesh The input mesh.
+    //! \param use_uniform_weights Use uniform instead of cotan weights.
+    //! \param clamp Whether or not negative cotan weights should be clamped to
+    //! zero.
+    //! \throw InvalidInputException if cotan weights are requested for a mesh
+    //! that is not a triangle mesh.
+    explicit LaplaceOperator(const SurfaceMesh& mesh,
+                             bool use_uniform_weights = false,
+                             bool clamp = false);
+
+    //! Compute Y = L*X.
+    void multiply(const DenseMatrix& X, DenseMatrix& Y) const;
+
+    //! The diagonal of L.
+    Eigen::VectorXd diagonal() const;
+
+    //! The weight of edge \p e, i.e., the off-diagonal entry of L.
+    double weight(Edge e) const { return weights_[e.idx()]; }
+
+private:
+    const SurfaceMesh& mesh_;
+    std::vector<double> weights_;
+};
+
 } // namespace pmp
@@ -0,0 +1,210 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "pmp/algorithms/multigrid.h"
+#include "pmp/algorithms/decimation.h"
+
+#include <string>
+
+namespace pmp {
+namespace {
+
+// damping factor of the Jacobi smoother and prolongation smoothing
+constexpr double omega = 2.0 / 3.0;
+
+// number of pre- and post-smoothing steps
+constexpr unsigned int n_smoothing_steps = 2;
+
+} // namespace
+
+MultigridSolver::MultigridSolver(const SurfaceMesh& mesh,
+                                 unsigned int coarsest_size)
+{
+    if (!mesh.is_triangle_mesh() ||
+        mesh.n_vertices() != mesh.vertices_size() ||
+        mesh.n_faces() != mesh.faces_size())
+    {
+        auto what = std::string{__func__} +
+                    ": Input is not a triangle mesh or has deleted elements.";
+        throw InvalidInputException(what);
+    }
+
+    SurfaceMesh coarse;
+    coarse.assign(mesh);
+
+    while (coarse.n_vertices() > coarsest_size)
+    {
+        const SurfaceMesh fine = coarse;
+        const unsigned int n = fine.n_vertices();
+
+        // decimate, remembering the fine index of the surviving vertices
+        auto index = coarse.add_vertex_property<int>("multigrid:index");
+        for (auto v : coarse.vertices())
+            index[v] = v.idx();
+        decimate(coarse, std::max(coarsest_size, n / 4));
+
+        // aggregate fine vertices to the closest surviving vertex
+        std::vector<int> aggregate(n, -1);
+        std::vector<Vertex> queue;
+        queue.reserve(n);
+        for (auto v : coarse.vertices())
+        {
+            aggregate[index[v]] = v.idx();
+            queue.emplace_back(index[v]);
+        }
+        coarse.remove_vertex_property(index);
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            for (auto vv : fine.vertices(queue[i]))
+            {
+                if (aggregate[vv.idx()] == -1)
+                {
+                    aggregate[vv.idx()] = aggregate[queue[i].idx()];
+                    queue.push_back(vv);
+                }
+            }
+        }
+
+        // piecewise constant prolongation. decimation keeps at least one
+        // vertex of each connected component, such that all vertices are
+        // reached from a surviving one.
+        std::vector<Triplet> triplets;
+        triplets.reserve(n);
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            assert(aggregate[i] >= 0);
+            triplets.emplace_back(i, aggregate[i], 1.0);
+        }
+        SparseMatrix P(n, coarse.n_vertices());
+        P.setFromTriplets(triplets.begin(), triplets.end());
+        prolongations_.push_back(std::move(P));
+
+        // stop if decimation does not make enough progress
+        if (coarse.n_vertices() > n / 2)
+            break;
+    }
+}
+
+void MultigridSolver::compute(
+    const SparseMatrix& A,
+    const std::function<bool(unsigned int)>& is_constrained)
+{
+    const Eigen::Index n = prolongations_.empty()
+                               ? A.rows()
+                               : prolongations_.front().rows();
+    if (A.rows() != n || A.cols() != n)
+    {
+        auto what = std::string{__func__} + ": Matrix dimensions differ.";
+        throw InvalidInputException(what);
+    }
+
+    A_ = A;
+    is_constrained_ = is_constrained;
+    levels_.resize(n_levels());
+
+    // decouple constrained entries by identity rows and columns
+    if (is_constrained)
+    {
+        std::vector<Triplet> triplets;
+        triplets.reserve(A.nonZeros());
+        for (Eigen::Index k = 0; k < A.outerSize(); ++k)
+        {
+            if (is_constrained(k))
+            {
+                triplets.emplace_back(k, k, 1.0);
+                continue;
+            }
+            for (SparseMatrix::InnerIterator iter(A, k); iter; ++iter)
+                if (!is_constrained(iter.row()))
+                    triplets.emplace_back(iter.row(), iter.col(),
+                                          iter.value());
+        }
+        levels_[0].A.resize(n, n);
+        levels_[0].A.setFromTriplets(triplets.begin(), triplets.end());
+    }
+    else
+    {
+        levels_[0].A = A;
+    }
+
+    for (size_t l = 0; l < levels_.size(); ++l)
+    {
+        Level& level = levels_[l];
+        level.inverse_diagonal = level.A.diagonal();
+        for (auto& d : level.inverse_diagonal)
+            d = std::abs(d) > std::numeric_limits<double>::min() ? 1.0 / d
+                                                                 : 0.0;
+
+        if (l + 1 == levels_.size())
+            break;
+
+        // smoothed prolongation and Galerkin coarse operator
+        const SparseMatrix& P0 = prolongations_[l];
+        const SparseMatrix DAP0 =
+            level.inverse_diagonal.asDiagonal() * (level.A * P0);
+        level.P = P0 - omega * DAP0;
+        const SparseMatrix AP = level.A * level.P;
+        levels_[l + 1].A = SparseMatrix(level.P.transpose()) * AP;
+    }
+
+    coarse_solver_.compute(levels_.back().A);
+    if (coarse_solver_.info() != Eigen::Success)
+    {
+        auto what =
+            std::string{__func__} + ": Failed to factorize coarsest level.";
+        throw SolverException(what);
+    }
+}
+
+unsigned int MultigridSolver::solve(const DenseMatrix& B, DenseMatrix& X,
+                                    double tolerance,
+                                    unsigned int max_iterations) const
+{
+    auto A = [&](const DenseMatrix& x, DenseMatrix& y) { y = A_ * x; };
+    auto preconditioner = [&](const DenseMatrix& R, DenseMatrix& Z) {
+        vcycle(R, Z);
+    };
+    return preconditioned_conjugate_gradient_solve(
+        A, preconditioner, B, X, is_constrained_, tolerance, max_iterations);
+}
+
+void MultigridSolver::vcycle(const DenseMatrix& R, DenseMatrix& Z) const
+{
+    vcycle(0, R, Z);
+}
+
+void MultigridSolver::vcycle(unsigned int l, const DenseMatrix& B,
+                             DenseMatrix& X) const
+{
+    const Level& level = levels_[l];
+
+    // exact solve on the coarsest level
+    if (l + 1 == levels_.size())
+    {
+        X = coarse_solver_.solve(B);
+        return;
+    }
+
+    // pre-smoothing
+    X = DenseMatrix::Zero(B.rows(), B.cols());
+    smooth(level, B, X);
+
+    // coarse grid correction
+    const DenseMatrix R = B - level.A * X;
+    const DenseMatrix Bc = level.P.transpose() * R;
+    DenseMatrix Xc;
+    vcycle(l + 1, Bc, Xc);
+    X += level.P * Xc;
+
+    // post-smoothing
+    smooth(level, B, X);
+}
+
+void MultigridSolver::smooth(const Level& level, const DenseMatrix& B,
+                             DenseMatrix& X) const
+{
+    for (unsigned int i = 0; i < n_smoothing_steps; ++i)
+        X += omega * (level.inverse_diagonal.asDiagonal() * (B - level.A * X));
+}
+
+} // namespace pmp
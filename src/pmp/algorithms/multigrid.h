@@ -0,0 +1,90 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+#include "pmp/algorithms/numerics.h"
+
+namespace pmp {
+
+//! \brief Geometric multigrid solver for Laplacian systems on a mesh.
+//! \details The hierarchy of coarser meshes is built by repeated decimation.
+//! Each vertex of a finer level is aggregated to the closest surviving vertex
+//! of the next coarser level. Prolongation operators are obtained by smoothing
+//! the resulting piecewise constant interpolation with one damped Jacobi step,
+//! and coarse operators by the Galerkin product \f$P^T A P\f$. The system on
+//! the coarsest level is solved by sparse Cholesky factorization.
+//! The solver uses V-cycles with damped Jacobi smoothing as preconditioner
+//! for the conjugate gradient method.
+//! \ingroup algorithms
+class MultigridSolver
+{
+public:
+    //! \brief Build the mesh hierarchy.
+    //! \param mesh The input mesh.
+    //! \param coarsest_size The target number of vertices of the coarsest
+    //! level.
+    //! \pre Input mesh needs to be a triangle mesh without deleted elements.
+    //! \throw InvalidInputException if the input precondition is violated.
+    explicit MultigridSolver(const SurfaceMesh& mesh,
+                             unsigned int coarsest_size = 1000);
+
+    //! \brief Set up the operators of all levels for the system matrix \p A.
+    //! \param A The system matrix, indexed by vertex index.
+    //! \param is_constrained A function returning whether or not X(i) is
+    //! constrained. Pass an empty function for no constraints.
+    //! \pre The matrix A has to be symmetric and positive definite on the
+    //! unconstrained entries.
+    //! \throw InvalidInputException if the dimension of A does not match.
+    //! \throw SolverException in case of failure to factorize the coarsest
+    //! level.
+    void compute(const SparseMatrix& A,
+                 const std::function<bool(unsigned int)>& is_constrained = {});
+
+    //! \brief Solve A*X=B by multigrid-preconditioned conjugate gradients.
+    //! \param B The right hand side.
+    //! \param X The initial guess on input, the solution on output.
+    //! Constrained entries keep their values.
+    //! \param tolerance The relative tolerance of the residual.
+    //! \param max_iterations The maximum number of iterations.
+    //! \return The number of iterations performed.
+    //! \throw SolverException if the solver did not converge.
+    unsigned int solve(const DenseMatrix& B, DenseMatrix& X,
+                       double tolerance = 1e-8,
+                       unsigned int max_iterations = 1000) const;
+
+    //! \brief Apply one V-cycle to approximate Z = A^-1 R.
+    //! \details Can be used as Preconditioner for
+    //! preconditioned_conjugate_gradient_solve().
+    void vcycle(const DenseMatrix& R, DenseMatrix& Z) const;
+
+    //! The number of levels, including the input mesh.
+    unsigned int n_levels() const { return prolongations_.size() + 1; }
+
+private:
+    struct Level
+    {
+        SparseMatrix A;                   // system matrix
+        SparseMatrix P;                   // prolongation from next level
+        Eigen::VectorXd inverse_diagonal; // for Jacobi smoothing
+    };
+
+    void vcycle(unsigned int level, const DenseMatrix& B,
+                DenseMatrix& X) const;
+    void smooth(const Level& level, const DenseMatrix& B,
+                DenseMatrix& X) const;
+
+    // piecewise constant prolongations from the decimation aggregates
+    std::vector<SparseMatrix> prolongations_;
+
+    SparseMatrix A_; // the input system matrix
+    std::vector<Level> levels_;
+    Eigen::SimplicialLDLT<SparseMatrix> coarse_solver_;
+    std::function<bool(unsigned int)> is_constrained_;
+};
+
+} // namespace pmp
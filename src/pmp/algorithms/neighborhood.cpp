@@ -0,0 +1,123 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "pmp/algorithms/neighborhood.h"
+#include "pmp/exceptions.h"
+
+#include <algorithm>
+#include <string>
+
+namespace pmp {
+namespace {
+
+// Collect the k-ring of v ring by ring, excluding v. visited[w] == tag marks
+// the vertices collected so far, such that the marks do not have to be
+// reset between vertices with distinct tags.
+void collect_rings(const SurfaceMesh& mesh, Vertex v, unsigned int k,
+                   unsigned int tag, std::vector<unsigned int>& visited,
+                   std::vector<Vertex>& rings)
+{
+    rings.clear();
+    visited[v.idx()] = tag;
+
+    auto add_ring = [&](Vertex w) {
+        for (auto vv : mesh.vertices(w))
+        {
+            if (visited[vv.idx()] != tag)
+            {
+                visited[vv.idx()] = tag;
+                rings.push_back(vv);
+            }
+        }
+    };
+
+    add_ring(v);
+    size_t begin = 0;
+    for (unsigned int r = 1; r < k; ++r)
+    {
+        const size_t end = rings.size();
+        for (size_t i = begin; i < end; ++i)
+            add_ring(rings[i]);
+        begin = end;
+    }
+}
+
+} // namespace
+
+NeighborhoodIndex::NeighborhoodIndex(const SurfaceMesh& mesh, unsigned int k)
+    : k_(k)
+{
+    if (k == 0)
+    {
+        auto what = std::string{__func__} + ": Invalid number of rings.";
+        throw InvalidInputException(what);
+    }
+    update(mesh);
+}
+
+void NeighborhoodIndex::update(const SurfaceMesh& mesh)
+{
+    const int nv = mesh.vertices_size();
+    offsets_.assign(nv + 1, 0);
+
+    // the rings are collected twice, first to count and then to store the
+    // neighbors of each vertex, with distinct tags in both passes
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<unsigned int> visited(k_ > 1 ? nv : 0, 0);
+        std::vector<Vertex> rings;
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int i = 0; i < nv; ++i)
+        {
+            const Vertex v(i);
+            if (mesh.is_deleted(v))
+                continue;
+            if (k_ == 1)
+            {
+                offsets_[i + 1] = mesh.valence(v);
+            }
+            else
+            {
+                collect_rings(mesh, v, k_, i + 1, visited, rings);
+                offsets_[i + 1] = rings.size();
+            }
+        }
+
+#ifdef _OPENMP
+#pragma omp single
+#endif
+        {
+            for (int i = 0; i < nv; ++i)
+                offsets_[i + 1] += offsets_[i];
+            neighbors_.resize(offsets_[nv]);
+        }
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int i = 0; i < nv; ++i)
+        {
+            const Vertex v(i);
+            if (mesh.is_deleted(v))
+                continue;
+            auto* neighbors = neighbors_.data() + offsets_[i];
+            if (k_ == 1)
+            {
+                for (auto vv : mesh.vertices(v))
+                    *neighbors++ = vv;
+            }
+            else
+            {
+                collect_rings(mesh, v, k_, nv + i + 1, visited, rings);
+                std::ranges::copy(rings, neighbors);
+            }
+        }
+    }
+}
+
+} // namespace pmp
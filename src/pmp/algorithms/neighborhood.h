@@ -0,0 +1,51 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+
+namespace pmp {
+
+//! \brief Precomputed k-ring neighborhoods of all vertices of a mesh.
+//! \details The neighbors of all vertices are stored contiguously in
+//! compressed sparse row format, such that traversing a neighborhood is a
+//! linear scan instead of nested circulations. The neighbors of a vertex are
+//! sorted by ring, the one-ring in the order of mesh.vertices(v). The index
+//! is built in parallel if OpenMP is available. It does not keep a reference
+//! to the mesh and has to be updated after changes of the connectivity.
+//! \ingroup algorithms
+class NeighborhoodIndex
+{
+public:
+    //! \brief Build the index of the \p k -ring neighborhoods of \p mesh.
+    //! \throw InvalidInputException if k is zero.
+    explicit NeighborhoodIndex(const SurfaceMesh& mesh, unsigned int k = 1);
+
+    //! \brief Rebuild the index after the connectivity of \p mesh changed.
+    void update(const SurfaceMesh& mesh);
+
+    //! \brief The vertices of the k-ring of \p v, excluding \p v itself.
+    //! \details Deleted vertices have no neighbors.
+    std::span<const Vertex> neighbors(Vertex v) const
+    {
+        return {neighbors_.data() + offsets_[v.idx()],
+                neighbors_.data() + offsets_[v.idx() + 1]};
+    }
+
+    //! The number of rings of the neighborhoods.
+    unsigned int k() const { return k_; }
+
+    //! The total number of neighbors of all vertices.
+    size_t n_neighbors() const { return neighbors_.size(); }
+
+private:
+    unsigned int k_;
+    std::vector<size_t> offsets_; // begin of each vertex' neighbors
+    std::vector<Vertex> neighbors_;
+};
+
+} // namespace pmp
@@ -3,108 +3,457 @@
 
 #include "pmp/algorithms/numerics.h"
 
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
 namespace pmp {
 
-DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& b)
+namespace {
+
+// does A have the given compressed sparsity pattern?
+bool same_pattern(const SparseMatrix& A,
+                  const std::vector<SparseMatrix::StorageIndex>& outer,
+                  const std::vector<SparseMatrix::StorageIndex>& inner)
+{
+    assert(A.isCompressed());
+    return A.outerSize() + 1 == (Eigen::Index)outer.size() &&
+           A.nonZeros() == (Eigen::Index)inner.size() &&
+           std::equal(outer.begin(), outer.end(), A.outerIndexPtr()) &&
+           std::equal(inner.begin(), inner.end(), A.innerIndexPtr());
+}
+
+// iterative refinement of single precision solutions
+constexpr double refinement_tolerance = 1e-10;
+constexpr unsigned int max_refinement_steps = 10;
+
+// Flushes subnormal numbers to zero within its scope. Entries of sparse
+// Cholesky factors decay quickly away from the diagonal, and arithmetic on
+// single precision subnormals is very slow on x86 CPUs. The lost accuracy is
+// recovered by iterative refinement.
+class FlushSubnormals
+{
+public:
+#if defined(__SSE__) || defined(_M_X64)
+    FlushSubnormals() : csr_(_mm_getcsr())
+    {
+        // flush-to-zero and denormals-are-zero bits
+        _mm_setcsr(csr_ | 0x8040);
+    }
+    ~FlushSubnormals() { _mm_setcsr(csr_); }
+
+private:
+    unsigned int csr_;
+#else
+    // user-provided to avoid unused variable warnings
+    FlushSubnormals() {}
+    ~FlushSubnormals() {}
+#endif
+};
+
+// Call solve() and replace the name of the failing solver member in the
+// messages of its exceptions by func, such that errors of the free solver
+// functions name the public entry point.
+template <typename Solve>
+DenseMatrix with_function_name(const std::string& func, Solve&& solve)
+{
+    auto rename = [&](const char* what) {
+        const std::string message(what);
+        const auto colon = message.find(": ");
+        return func + (colon == std::string::npos ? ": " + message
+                                                  : message.substr(colon));
+    };
+
+    try
+    {
+        return solve();
+    }
+    catch (const SolverException& e)
+    {
+        throw SolverException(rename(e.what()));
+    }
+    catch (const InvalidInputException& e)
+    {
+        throw InvalidInputException(rename(e.what()));
+    }
+}
+
+} // namespace
+
+void SparseSolverCache::factorize(const SparseMatrix& A)
 {
-    Eigen::SimplicialLDLT<SparseMatrix> solver;
-    solver.compute(A);
-    if (solver.info() != Eigen::Success)
+    if (!A.isCompressed())
+    {
+        factorize(SparseMatrix(A));
+        return;
+    }
+
+    const bool single = precision_ == FactorizationPrecision::Single;
+    Eigen::SparseMatrix<float> Af;
+    if (single)
     {
+        Af = A.cast<float>();
+        A_ = A;
+    }
+
+    // symbolic analysis, only if the sparsity pattern has changed
+    if (!same_pattern(A, outer_, inner_))
+    {
+        if (single)
+            float_solver_.analyzePattern(Af);
+        else
+            solver_.analyzePattern(A);
+        outer_.assign(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1);
+        inner_.assign(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros());
+        ++n_analyses_;
+    }
+
+    // numerical factorization
+    if (single)
+    {
+        FlushSubnormals flush;
+        float_solver_.factorize(Af);
+    }
+    else
+        solver_.factorize(A);
+    if ((single ? float_solver_.info() : solver_.info()) != Eigen::Success)
+    {
+        // force a new analysis next time
+        outer_.clear();
+        inner_.clear();
+
         auto what =
             std::string{__func__} + ": Failed to factorize linear system.";
         throw SolverException(what);
     }
+}
+
+DenseMatrix SparseSolverCache::solve(const DenseMatrix& B) const
+{
+    if (precision_ == FactorizationPrecision::Single)
+        return refine(B);
 
-    const DenseMatrix x = solver.solve(b);
-    if (solver.info() != Eigen::Success)
+    DenseMatrix X = solver_.solve(B);
+    if (solver_.info() != Eigen::Success)
     {
         auto what = std::string{__func__} + ": Failed to solve linear system.";
         throw SolverException(what);
     }
+    return X;
+}
+
+DenseMatrix SparseSolverCache::refine(const DenseMatrix& B) const
+{
+    const auto func = std::string{__func__};
+    auto solve_float = [&](const DenseMatrix& R) {
+        FlushSubnormals flush;
+        const Eigen::MatrixXf Xf = float_solver_.solve(R.cast<float>());
+        if (float_solver_.info() != Eigen::Success)
+        {
+            auto what = func + ": Failed to solve linear system.";
+            throw SolverException(what);
+        }
+        return DenseMatrix(Xf.cast<double>());
+    };
 
-    return x;
+    // refine the single precision solution using double precision residuals
+    DenseMatrix X = solve_float(B);
+    const double threshold = refinement_tolerance * B.norm();
+    for (unsigned int i = 0;; ++i)
+    {
+        const DenseMatrix R = B - A_ * X;
+        if (R.norm() <= threshold)
+            break;
+        if (i == max_refinement_steps)
+        {
+            auto what = func + ": Iterative refinement did not converge.";
+            throw SolverException(what);
+        }
+        X += solve_float(R);
+    }
+    return X;
 }
 
-DenseMatrix cholesky_solve(
-    const SparseMatrix& A, const DenseMatrix& B,
-    const std::function<bool(unsigned int)>& is_constrained,
-    const DenseMatrix& C)
+DenseMatrix SparseSolverCache::solve(const SparseMatrix& A,
+                                     const DenseMatrix& B)
 {
-    // if nothing is fixed, then use unconstrained solve
-    int n_constraints(0);
-    for (int i = 0; i < A.cols(); ++i)
+    factorize(A);
+    return solve(B);
+}
+
+ConstrainedSolver::ConstrainedSolver(
+    unsigned int n, const std::function<bool(unsigned int)>& is_constrained,
+    FactorizationPrecision precision)
+    : solver_(precision)
+{
+    for (unsigned int i = 0; i < n; ++i)
+    {
         if (is_constrained(i))
-            ++n_constraints;
-    if (!n_constraints)
-        return cholesky_solve(A, B);
-
-    // build index map; n is #dofs
-    int n = 0;
-    std::vector<int> idx(A.cols(), -1);
-    for (int i = 0; i < A.cols(); ++i)
-        if (!is_constrained(i))
-            idx[i] = n++;
-
-    // copy columns for rhs
-    DenseMatrix BB(n, B.cols());
-    for (int i = 0; i < A.cols(); ++i)
-        if (idx[i] != -1)
-            BB.row(idx[i]) = B.row(i);
-
-    // collect entries for reduced matrix
-    // update rhs with constraints
-    std::vector<Triplet> triplets;
-    triplets.reserve(A.nonZeros());
-    for (unsigned int k = 0; k < A.outerSize(); k++)
+            constraints_.push_back(i);
+        else
+            dofs_.push_back(i);
+    }
+}
+
+void ConstrainedSolver::analyze_pattern(const SparseMatrix& A)
+{
+    // reduced index of each entry, -1 for constrained ones
+    const Eigen::Index n = A.cols();
+    std::vector<int> dof_index(n, -1), constraint_index(n, -1);
+    for (size_t k = 0; k < dofs_.size(); ++k)
+        dof_index[dofs_[k]] = k;
+    for (size_t k = 0; k < constraints_.size(); ++k)
+        constraint_index[constraints_[k]] = k;
+
+    // reduced indices preserve the order of rows and columns, such that
+    // the entries of the reduced matrices are collected in storage order
+    std::vector<Triplet> AA_triplets, AC_triplets;
+    AA_sources_.clear();
+    AC_sources_.clear();
+    for (Eigen::Index j = 0; j < n; ++j)
     {
-        for (SparseMatrix::InnerIterator iter(A, k); iter; ++iter)
+        for (auto k = A.outerIndexPtr()[j]; k < A.outerIndexPtr()[j + 1]; ++k)
         {
-            const int i = iter.row();
-            const int j = iter.col();
+            const int i = dof_index[A.innerIndexPtr()[k]];
+            if (i == -1) // row is constraint
+                continue;
 
-            if (idx[i] != -1) // row is dof
+            if (dof_index[j] != -1) // col is dof
+            {
+                AA_triplets.emplace_back(i, dof_index[j], 0.0);
+                AA_sources_.push_back(k);
+            }
+            else // col is constraint
             {
-                if (idx[j] != -1) // col is dof
-                {
-                    triplets.emplace_back(idx[i], idx[j], iter.value());
-                }
-                else // col is constraint
-                {
-                    BB.row(idx[i]) -= iter.value() * C.row(j);
-                }
+                AC_triplets.emplace_back(i, constraint_index[j], 0.0);
+                AC_sources_.push_back(k);
             }
         }
     }
-    SparseMatrix AA(n, n);
-    AA.setFromTriplets(triplets.begin(), triplets.end());
 
-    // factorize system
-    Eigen::SimplicialLDLT<SparseMatrix> solver;
-    solver.compute(AA);
-    if (solver.info() != Eigen::Success)
+    AA_.resize(dofs_.size(), dofs_.size());
+    AA_.setFromTriplets(AA_triplets.begin(), AA_triplets.end());
+    AC_.resize(dofs_.size(), constraints_.size());
+    AC_.setFromTriplets(AC_triplets.begin(), AC_triplets.end());
+    assert(AA_.nonZeros() == (Eigen::Index)AA_sources_.size());
+    assert(AC_.nonZeros() == (Eigen::Index)AC_sources_.size());
+
+    outer_.assign(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1);
+    inner_.assign(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros());
+    factorized_ = false;
+}
+
+void ConstrainedSolver::factorize(const SparseMatrix& A)
+{
+    const auto n = Eigen::Index(dofs_.size() + constraints_.size());
+    if (A.rows() != n || A.cols() != n)
     {
-        auto what =
-            std::string{__func__} + ": Failed to factorize linear system.";
-        throw SolverException(what);
+        auto what = std::string{__func__} + ": Matrix dimensions differ.";
+        throw InvalidInputException(what);
     }
 
-    // solve system
-    const DenseMatrix XX = solver.solve(BB);
-    if (solver.info() != Eigen::Success)
+    if (!A.isCompressed())
     {
-        auto what = std::string{__func__} + ": Failed to solve linear system.";
-        throw SolverException(what);
+        factorize(SparseMatrix(A));
+        return;
+    }
+
+    // reduced patterns, only if the sparsity pattern has changed
+    if (!same_pattern(A, outer_, inner_))
+        analyze_pattern(A);
+
+    // copy coefficients, keeping track of changes of the reduced system
+    const double* values = A.valuePtr();
+    bool changed = !factorized_;
+    for (size_t k = 0; k < AA_sources_.size(); ++k)
+    {
+        const double value = values[AA_sources_[k]];
+        changed |= AA_.valuePtr()[k] != value;
+        AA_.valuePtr()[k] = value;
+    }
+    for (size_t k = 0; k < AC_sources_.size(); ++k)
+        AC_.valuePtr()[k] = values[AC_sources_[k]];
+
+    if (dofs_.empty() || !changed)
+        return;
+
+    try
+    {
+        solver_.factorize(AA_);
+        factorized_ = true;
+        ++n_factorizations_;
+    }
+    catch (const SolverException&)
+    {
+        // force a new analysis next time
+        outer_.clear();
+        inner_.clear();
+        factorized_ = false;
+        throw;
     }
+}
 
-    // build full-size result vector from solver result (X) and constraints (C)
-    DenseMatrix X(B.rows(), B.cols());
-    for (int i = 0; i < A.cols(); ++i)
-        X.row(i) = idx[i] == -1 ? C.row(i) : XX.row(idx[i]);
+DenseMatrix ConstrainedSolver::solve(const DenseMatrix& B,
+                                     const DenseMatrix& C) const
+{
+    const auto n = Eigen::Index(dofs_.size() + constraints_.size());
+    if (B.rows() != n || C.rows() != n || B.cols() != C.cols())
+    {
+        auto what = std::string{__func__} + ": Matrix dimensions differ.";
+        throw InvalidInputException(what);
+    }
+
+    // constrained values
+    DenseMatrix CC(constraints_.size(), C.cols());
+    for (size_t k = 0; k < constraints_.size(); ++k)
+        CC.row(k) = C.row(constraints_[k]);
+
+    // build full-size result from constraints (C)...
+    DenseMatrix X(n, B.cols());
+    for (size_t k = 0; k < constraints_.size(); ++k)
+        X.row(constraints_[k]) = CC.row(k);
+    if (dofs_.empty())
+        return X;
+
+    // ...and solution of the reduced system, with constraints moved to the
+    // right hand side
+    DenseMatrix BB(dofs_.size(), B.cols());
+    for (size_t k = 0; k < dofs_.size(); ++k)
+        BB.row(k) = B.row(dofs_[k]);
+    BB -= AC_ * CC;
+    const DenseMatrix XX = solver_.solve(BB);
+    for (size_t k = 0; k < dofs_.size(); ++k)
+        X.row(dofs_[k]) = XX.row(k);
 
     return X;
 }
 
+DenseMatrix ConstrainedSolver::solve(const SparseMatrix& A,
+                                     const DenseMatrix& B,
+                                     const DenseMatrix& C)
+{
+    factorize(A);
+    return solve(B, C);
+}
+
+DenseMatrix cholesky_solve(const SparseMatrix& A, const DenseMatrix& b)
+{
+    return with_function_name(__func__,
+                              [&] { return SparseSolverCache().solve(A, b); });
+}
+
+DenseMatrix cholesky_solve(
+    const SparseMatrix& A, const DenseMatrix& B,
+    const std::function<bool(unsigned int)>& is_constrained,
+    const DenseMatrix& C)
+{
+    return with_function_name(__func__, [&] {
+        return ConstrainedSolver(A.cols(), is_constrained).solve(A, B, C);
+    });
+}
+
+unsigned int conjugate_gradient_solve(
+    const LinearOperator& A, const Eigen::VectorXd& diagonal,
+    const DenseMatrix& B, DenseMatrix& X,
+    const std::function<bool(unsigned int)>& is_constrained, double tolerance,
+    unsigned int max_iterations)
+{
+    if (diagonal.size() && diagonal.size() != B.rows())
+    {
+        auto what = std::string{__func__} + ": Matrix dimensions differ.";
+        throw InvalidInputException(what);
+    }
+
+    // inverse diagonal as preconditioner
+    Eigen::VectorXd inverse_diagonal = Eigen::VectorXd::Ones(B.rows());
+    if (diagonal.size())
+        for (Eigen::Index i = 0; i < B.rows(); ++i)
+            if (std::abs(diagonal[i]) > std::numeric_limits<double>::min())
+                inverse_diagonal[i] = 1.0 / diagonal[i];
+
+    auto jacobi = [&](const DenseMatrix& R, DenseMatrix& Z) {
+        Z = inverse_diagonal.asDiagonal() * R;
+    };
+    return preconditioned_conjugate_gradient_solve(
+        A, jacobi, B, X, is_constrained, tolerance, max_iterations);
+}
+
+unsigned int preconditioned_conjugate_gradient_solve(
+    const LinearOperator& A, const Preconditioner& preconditioner,
+    const DenseMatrix& B, DenseMatrix& X,
+    const std::function<bool(unsigned int)>& is_constrained, double tolerance,
+    unsigned int max_iterations)
+{
+    const Eigen::Index n = B.rows();
+    const Eigen::Index m = B.cols();
+    if (X.rows() != n || X.cols() != m)
+    {
+        auto what = std::string{__func__} + ": Matrix dimensions differ.";
+        throw InvalidInputException(what);
+    }
+
+    // mask out constrained entries
+    Eigen::VectorXd mask = Eigen::VectorXd::Ones(n);
+    if (is_constrained)
+        for (Eigen::Index i = 0; i < n; ++i)
+            if (is_constrained(i))
+                mask[i] = 0.0;
+
+    // initial residual
+    DenseMatrix AP(n, m);
+    A(X, AP);
+    DenseMatrix R = mask.asDiagonal() * (B - AP);
+    DenseMatrix Z;
+    preconditioner(R, Z);
+    Z = mask.asDiagonal() * Z;
+    DenseMatrix P = Z;
+    Eigen::VectorXd rz = (R.array() * Z.array()).colwise().sum();
+
+    // convergence thresholds per column
+    Eigen::VectorXd threshold(m);
+    for (Eigen::Index j = 0; j < m; ++j)
+        threshold[j] =
+            tolerance * std::max((mask.asDiagonal() * B.col(j)).norm(),
+                                 R.col(j).norm());
+
+    for (unsigned int iter = 0; iter < max_iterations; ++iter)
+    {
+        // converged?
+        bool converged = true;
+        for (Eigen::Index j = 0; j < m; ++j)
+            if (R.col(j).norm() > threshold[j])
+                converged = false;
+        if (converged)
+            return iter;
+
+        A(P, AP);
+        AP = mask.asDiagonal() * AP;
+
+        for (Eigen::Index j = 0; j < m; ++j)
+        {
+            const double pap = P.col(j).dot(AP.col(j));
+            const double alpha = pap > 0.0 ? rz[j] / pap : 0.0;
+            X.col(j) += alpha * P.col(j);
+            R.col(j) -= alpha * AP.col(j);
+        }
+
+        preconditioner(R, Z);
+        Z = mask.asDiagonal() * Z;
+        for (Eigen::Index j = 0; j < m; ++j)
+        {
+            const double rz_new = R.col(j).dot(Z.col(j));
+            const double beta = rz[j] > 0.0 ? rz_new / rz[j] : 0.0;
+            P.col(j) = Z.col(j) + beta * P.col(j);
+            rz[j] = rz_new;
+        }
+    }
+
+    auto what = std::string{__func__} + ": Solver did not converge.";
+    throw SolverException(what);
+}
+
 void selector_matrix(const SurfaceMesh& mesh,
                      const std::function<bool(Vertex)>& is_selected,
                      SparseMatrix& S)
@@ -178,4 +527,23 @@ void matrix_to_coordinates(const DenseMatrix& X, SurfaceMesh& mesh)
         mesh.position(v) = X.row(v.idx());
 }
 
+void check_frames(const SurfaceMesh& mesh,
+                  const std::vector<std::vector<Point>>& frames,
+                  const std::string& func)
+{
+    if (mesh.n_vertices() != mesh.vertices_size())
+    {
+        auto what = func + ": Mesh has deleted vertices.";
+        throw InvalidInputException(what);
+    }
+    for (const auto& frame : frames)
+    {
+        if (frame.size() != mesh.n_vertices())
+        {
+            auto what = func + ": Frame size differs from number of vertices.";
+            throw InvalidInputException(what);
+        }
+    }
+}
+
 } // namespace pmp
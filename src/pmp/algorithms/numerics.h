@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "pmp/surface_mesh.h"
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
@@ -18,6 +21,69 @@ using DenseMatrix = Eigen::MatrixXd;
 //! PMP uses Eigen's double-precision triplets
 using Triplet = Eigen::Triplet<double>;
 
+//! Linear solvers available for Laplacian systems.
+enum class LinearSolver
+{
+    Cholesky,          //!< sparse Cholesky factorization
+    ConjugateGradient, //!< matrix-free preconditioned conjugate gradients
+    Multigrid,         //!< conjugate gradients with multigrid preconditioner
+    MixedPrecision     //!< single-precision Cholesky, refined in double
+};
+
+//! Floating point precision of sparse Cholesky factorizations.
+enum class FactorizationPrecision
+{
+    Double, //!< factorize in double precision
+    Single  //!< factorize in single precision, refine solutions in double
+};
+
+//! A linear operator computing Y = A*X, e.g., a matrix-free Laplacian.
+using LinearOperator =
+    std::function<void(const DenseMatrix& X, DenseMatrix& Y)>;
+
+//! Solve the linear system A*X=B by the preconditioned conjugate gradient
+//! method. All columns of B are solved simultaneously.
+//! The operator A is only accessed through products, such that it does not
+//! have to be assembled.
+//! \pre The operator A has to be symmetric and positive definite on the
+//! unconstrained entries. Semi-definite systems converge if B lies in the
+//! range of A.
+//! \param A The system operator.
+//! \param diagonal The diagonal of A, used as Jacobi preconditioner. Pass an
+//! empty vector for no preconditioning.
+//! \param B The right hand side.
+//! \param X The initial guess (warm start) on input, the solution on output.
+//! Constrained entries keep their values.
+//! \param is_constrained A function returning whether or not X(i) is
+//! constrained. Pass an empty function for no constraints.
+//! \param tolerance The tolerance for the residual norm of each column,
+//! relative to the larger of the norms of the right hand side and the initial
+//! residual.
+//! \param max_iterations The maximum number of iterations.
+//! \return The number of iterations performed.
+//! \throw InvalidInputException if the sizes of B, X, and \p diagonal do not
+//! match.
+//! \throw SolverException if the solver did not converge.
+unsigned int conjugate_gradient_solve(
+    const LinearOperator& A, const Eigen::VectorXd& diagonal,
+    const DenseMatrix& B, DenseMatrix& X,
+    const std::function<bool(unsigned int)>& is_constrained = {},
+    double tolerance = 1e-8, unsigned int max_iterations = 10000);
+
+//! A preconditioner computing an approximation Z of A^-1*R.
+using Preconditioner =
+    std::function<void(const DenseMatrix& R, DenseMatrix& Z)>;
+
+//! Solve the linear system A*X=B by the conjugate gradient method with a
+//! general preconditioner, e.g., a multigrid V-cycle.
+//! \pre The preconditioner has to be symmetric and positive definite.
+//! See conjugate_gradient_solve() for the other parameters.
+unsigned int preconditioned_conjugate_gradient_solve(
+    const LinearOperator& A, const Preconditioner& preconditioner,
+    const DenseMatrix& B, DenseMatrix& X,
+    const std::function<bool(unsigned int)>& is_constrained = {},
+    double tolerance = 1e-8, unsigned int max_iterations = 10000);
+
 //! Solve the linear system A*X=B using sparse Cholesky decomposition.
 //! Returns the solution vector/matrix X.
 //! \pre The matrix A has to be sparse, symmetric, and positive definite.
@@ -37,6 +103,142 @@ DenseMatrix cholesky_solve(
     const std::function<bool(unsigned int)>& is_constrained,
     const DenseMatrix& C);
 
+//! \brief Sparse Cholesky solver reusing the symbolic analysis across solves.
+//! \details The symbolic analysis (fill-reducing ordering and elimination
+//! tree) only depends on the sparsity pattern of the system matrix. It is
+//! computed once and reused as long as subsequent matrices have the same
+//! pattern, such that only the numerical factorization is redone.
+//! This speeds up repeated solves with changing coefficients, e.g., in
+//! iterative implicit smoothing.
+//!
+//! With FactorizationPrecision::Single, the factorization is computed and
+//! stored in single precision, which halves its memory and bandwidth
+//! requirements. Solutions are then refined by a few steps of iterative
+//! refinement with double-precision residuals until the relative residual
+//! drops below 1e-10. This requires a copy of the system matrix and is
+//! suited to well-conditioned systems such as implicit smoothing. It is not
+//! suited to ill-conditioned systems, or to solutions spanning many orders of
+//! magnitude such as the heat diffusion of the heat method.
+class SparseSolverCache
+{
+public:
+    //! Construct a solver factorizing in the given \p precision.
+    explicit SparseSolverCache(
+        FactorizationPrecision precision = FactorizationPrecision::Double)
+        : precision_(precision)
+    {
+    }
+
+    //! Factorize the matrix A, reusing the symbolic analysis if the sparsity
+    //! pattern of A matches the one of the previously factorized matrix.
+    //! \pre The matrix A has to be sparse, symmetric, and positive definite.
+    //! \throw SolverException in case of failure to factorize the matrix.
+    void factorize(const SparseMatrix& A);
+
+    //! Solve A*X=B for the previously factorized matrix A.
+    //! \throw SolverException in case of failure to solve the system, or if
+    //! iterative refinement does not converge for single precision
+    //! factorizations.
+    DenseMatrix solve(const DenseMatrix& B) const;
+
+    //! Factorize A and solve the linear system A*X=B.
+    //! \throw SolverException in case of failure to solve the system.
+    DenseMatrix solve(const SparseMatrix& A, const DenseMatrix& B);
+
+    //! Returns the number of symbolic analyses performed so far.
+    unsigned int n_analyses() const { return n_analyses_; }
+
+private:
+    DenseMatrix refine(const DenseMatrix& B) const;
+
+    FactorizationPrecision precision_;
+    Eigen::SimplicialLDLT<SparseMatrix> solver_;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<float>> float_solver_;
+    SparseMatrix A_; // system matrix for iterative refinement
+    std::vector<SparseMatrix::StorageIndex> outer_;
+    std::vector<SparseMatrix::StorageIndex> inner_;
+    unsigned int n_analyses_{0};
+};
+
+//! \brief Sparse Cholesky solver for a fixed set of hard constraints.
+//! \details Constrained entries are eliminated from the linear system.
+//! The mapping between full and reduced indices is computed once for the
+//! given constraints. The sparsity patterns of the reduced system and of the
+//! coupling to the constrained entries are computed once per sparsity
+//! pattern of the system matrix. Subsequent solves only copy the matrix
+//! coefficients and reuse the symbolic analysis of the reduced system.
+//! The numerical factorization is skipped as well if the coefficients of the
+//! reduced system did not change.
+//! This speeds up repeated constrained solves, e.g., in iterative implicit
+//! smoothing.
+class ConstrainedSolver
+{
+public:
+    //! Set up the elimination of constrained entries.
+    //! \param n The number of unknowns.
+    //! \param is_constrained A function returning whether or not X(i) is
+    //! constrained.
+    //! \param precision The precision of the factorization, see
+    //! SparseSolverCache.
+    ConstrainedSolver(
+        unsigned int n, const std::function<bool(unsigned int)>& is_constrained,
+        FactorizationPrecision precision = FactorizationPrecision::Double);
+
+    //! Factorize the reduced system of A.
+    //! \pre The matrix A has to be sparse, symmetric, and positive definite
+    //! on the unconstrained entries.
+    //! \throw InvalidInputException if the dimensions of A do not match.
+    //! \throw SolverException in case of failure to factorize the matrix.
+    void factorize(const SparseMatrix& A);
+
+    //! Solve A*X=B for the previously factorized matrix A.
+    //! \param B The right hand side.
+    //! \param C A matrix storing the Dirichlet constraints: X(i) should be
+    //! C(i) if entry i is constrained.
+    //! \throw InvalidInputException if the dimensions of B or C do not match.
+    //! \throw SolverException in case of failure to solve the system.
+    DenseMatrix solve(const DenseMatrix& B, const DenseMatrix& C) const;
+
+    //! Factorize A and solve the linear system A*X=B.
+    //! \throw InvalidInputException if the dimensions do not match.
+    //! \throw SolverException in case of failure to solve the system.
+    DenseMatrix solve(const SparseMatrix& A, const DenseMatrix& B,
+                      const DenseMatrix& C);
+
+    //! Returns the number of unconstrained entries.
+    unsigned int n_dofs() const { return dofs_.size(); }
+
+    //! Returns the number of symbolic analyses of the reduced system
+    //! performed so far.
+    unsigned int n_analyses() const { return solver_.n_analyses(); }
+
+    //! Returns the number of numerical factorizations of the reduced system
+    //! performed so far.
+    unsigned int n_factorizations() const { return n_factorizations_; }
+
+private:
+    void analyze_pattern(const SparseMatrix& A);
+
+    // full indices of unconstrained and constrained entries
+    std::vector<int> dofs_;
+    std::vector<int> constraints_;
+
+    // sparsity pattern of the last factorized matrix
+    std::vector<SparseMatrix::StorageIndex> outer_;
+    std::vector<SparseMatrix::StorageIndex> inner_;
+
+    // reduced system and coupling to the constrained entries, together with
+    // the positions of their coefficients in the full system matrix
+    SparseMatrix AA_;
+    SparseMatrix AC_;
+    std::vector<Eigen::Index> AA_sources_;
+    std::vector<Eigen::Index> AC_sources_;
+
+    SparseSolverCache solver_;
+    bool factorized_{false}; // AA_ is factorized
+    unsigned int n_factorizations_{0};
+};
+
 //! Constructs a selector matrix for a mesh with N vertices.
 //! Returns a matrix built from the rows of the NxN identity matrix that belong to selected vertices.
 //! \param mesh The input mesh.
@@ -72,4 +274,15 @@ void coordinates_to_matrix(const SurfaceMesh& mesh, DenseMatrix& X);
 //! \ingroup algorithms
 void matrix_to_coordinates(const DenseMatrix& X, SurfaceMesh& mesh);
 
+//! \brief Check that each frame contains one position per vertex of a mesh.
+//! \param mesh The mesh.
+//! \param frames The vertex positions of each frame, indexed by vertex index.
+//! \param func The name of the calling function, used in error messages.
+//! \throw InvalidInputException if the mesh has deleted vertices or if the
+//! size of a frame differs from the number of vertices.
+//! \ingroup algorithms
+void check_frames(const SurfaceMesh& mesh,
+                  const std::vector<std::vector<Point>>& frames,
+                  const std::string& func);
+
 } // namespace pmp
@@ -9,242 +9,30 @@
 #include <memory>
 #include <limits>
 #include <numbers>
+#include <queue>
 
 #include "pmp/algorithms/curvature.h"
 #include "pmp/algorithms/normals.h"
 #include "pmp/algorithms/barycentric_coordinates.h"
+#include "pmp/algorithms/bvh.h"
 #include "pmp/algorithms/differential_geometry.h"
-#include "pmp/algorithms/distance_point_triangle.h"
-#include "pmp/bounding_box.h"
 
 namespace pmp {
 namespace {
 
-class TriangleKdTree
+// barycentric interpolation of per-vertex values at point p in face f
+Scalar interpolate(const SurfaceMesh& mesh, Face f, const Point& p,
+                   const std::vector<Scalar>& values)
 {
-public:
-    TriangleKdTree(std::shared_ptr<const SurfaceMesh> mesh,
-                   unsigned int max_faces = 10, unsigned int max_depth = 30);
-
-    ~TriangleKdTree() { delete root_; }
-
-    struct NearestNeighbor
-    {
-        Scalar dist;
-        Face face;
-        Point nearest;
-    };
-
-    NearestNeighbor nearest(const Point& p) const;
-
-private:
-    using Faces = std::vector<Face>;
-
-    struct Node
-    {
-        Node() = default;
-
-        ~Node()
-        {
-            delete faces;
-            delete left_child;
-            delete right_child;
-        }
-
-        unsigned char axis;
-        Scalar split;
-        Faces* faces{nullptr};
-        Node* left_child{nullptr};
-        Node* right_child{nullptr};
-    };
-
-    void build_recurse(Node* node, unsigned int max_handles,
-                       unsigned int depth);
-
-    void nearest_recurse(Node* node, const Point& point,
-                         NearestNeighbor& data) const;
-
-    Node* root_;
-    std::vector<std::array<Point, 3>> face_points_;
-};
-
-TriangleKdTree::TriangleKdTree(std::shared_ptr<const SurfaceMesh> mesh,
-                               unsigned int max_faces, unsigned int max_depth)
-{
-    // init
-    root_ = new Node();
-    root_->faces = new Faces();
-
-    // collect faces and points
-    root_->faces->reserve(mesh->n_faces());
-    face_points_.reserve(mesh->n_faces());
-    auto points = mesh->get_vertex_property<Point>("v:point");
-
-    for (const auto& f : mesh->faces())
-    {
-        root_->faces->push_back(f);
-
-        auto v = mesh->vertices(f);
-        const auto& p0 = points[*v];
-        ++v;
-        const auto& p1 = points[*v];
-        ++v;
-        const auto& p2 = points[*v];
-        face_points_.push_back({p0, p1, p2});
-    }
-
-    // call recursive helper
-    build_recurse(root_, max_faces, max_depth);
-}
-
-void TriangleKdTree::build_recurse(Node* node, unsigned int max_faces,
-                                   unsigned int depth)
-{
-    // should we stop at this level ?
-    if ((depth == 0) || (node->faces->size() <= max_faces))
-        return;
-
-    // compute bounding box
-    BoundingBox bbox;
-    for (const auto& f : *node->faces)
-    {
-        const auto idx = f.idx();
-        bbox += face_points_[idx][0];
-        bbox += face_points_[idx][1];
-        bbox += face_points_[idx][2];
-    }
-
-    // split longest side of bounding box
-    Point bb = bbox.max() - bbox.min();
-    Scalar length = bb[0];
-    int axis = 0;
-    if (bb[1] > length)
-        length = bb[(axis = 1)];
-    if (bb[2] > length)
-        length = bb[(axis = 2)];
-
-    // split in the middle
-    const Scalar split = bbox.center()[axis];
-
-    // create children
-    auto* left = new Node();
-    left->faces = new Faces();
-    left->faces->reserve(node->faces->size() / 2);
-    auto* right = new Node();
-    right->faces = new Faces;
-    right->faces->reserve(node->faces->size() / 2);
-
-    // partition for left and right child
-    for (const auto& f : *node->faces)
-    {
-        bool l = false, r = false;
-
-        const auto& pos = face_points_[f.idx()];
-
-        if (pos[0][axis] <= split)
-            l = true;
-        else
-            r = true;
-        if (pos[1][axis] <= split)
-            l = true;
-        else
-            r = true;
-        if (pos[2][axis] <= split)
-            l = true;
-        else
-            r = true;
-
-        if (l)
-        {
-            left->faces->push_back(f);
-        }
-
-        if (r)
-        {
-            right->faces->push_back(f);
-        }
-    }
-
-    // stop here?
-    if (left->faces->size() == node->faces->size() ||
-        right->faces->size() == node->faces->size())
-    {
-        // compact my memory
-        node->faces->shrink_to_fit();
-
-        // delete new nodes
-        delete left;
-        delete right;
-
-        // stop recursion
-        return;
-    }
-
-    // or recurse further?
-    else
-    {
-        // free my memory
-        delete node->faces;
-        node->faces = nullptr;
-
-        // store internal data
-        node->axis = axis;
-        node->split = split;
-        node->left_child = left;
-        node->right_child = right;
-
-        // recurse to children
-        build_recurse(node->left_child, max_faces, depth - 1);
-        build_recurse(node->right_child, max_faces, depth - 1);
-    }
-}
-
-TriangleKdTree::NearestNeighbor TriangleKdTree::nearest(const Point& p) const
-{
-    NearestNeighbor data;
-    data.dist = std::numeric_limits<Scalar>::max();
-    nearest_recurse(root_, p, data);
-    return data;
-}
-
-void TriangleKdTree::nearest_recurse(Node* node, const Point& point,
-                                     NearestNeighbor& data) const
-{
-    // terminal node?
-    if (!node->left_child)
-    {
-        for (const auto& f : *node->faces)
-        {
-            Point n;
-            const auto& pos = face_points_[f.idx()];
-            auto d = dist_point_triangle(point, pos[0], pos[1], pos[2], n);
-            if (d < data.dist)
-            {
-                data.dist = d;
-                data.face = f;
-                data.nearest = n;
-            }
-        }
-    }
-
-    // non-terminal node
-    else
-    {
-        const Scalar dist = point[node->axis] - node->split;
-
-        if (dist <= 0.0)
-        {
-            nearest_recurse(node->left_child, point, data);
-            if (fabs(dist) < data.dist)
-                nearest_recurse(node->right_child, point, data);
-        }
-        else
-        {
-            nearest_recurse(node->right_child, point, data);
-            if (fabs(dist) < data.dist)
-                nearest_recurse(node->left_child, point, data);
-        }
-    }
+    auto fv = mesh.vertices(f);
+    const Vertex v0 = *fv;
+    const Vertex v1 = *++fv;
+    const Vertex v2 = *++fv;
+    const Point b = barycentric_coordinates(p, mesh.position(v0),
+                                            mesh.position(v1),
+                                            mesh.position(v2));
+    return b[0] * values[v0.idx()] + b[1] * values[v1.idx()] +
+           b[2] * values[v2.idx()];
 }
 
 class Remeshing
@@ -257,22 +45,45 @@ public:
 
     void adaptive_remeshing(Scalar min_edge_length, Scalar max_edge_length,
                             Scalar approx_error, unsigned int iterations = 10,
-                            bool use_projection = true);
+                            bool use_projection = true,
+                            const SizingField* sizing_field = nullptr);
 
 private:
     void preprocessing();
     void postprocessing();
 
+    // collect all vertices and edges that are not locked
+    void init_active_elements();
+    // remove deleted and add newly created elements to the active ones
+    void update_active_elements();
+
+    void update_vertex_normals();
+
     void split_long_edges();
     void collapse_short_edges();
     void flip_edges();
     void tangential_smoothing(unsigned int iterations);
     void remove_caps();
 
-    Point minimize_squared_areas(Vertex v);
-    Point weighted_centroid(Vertex v);
+    // tangential smoothing update of a vertex on a feature line
+    Point feature_update(Vertex v) const;
+    // tangential smoothing update of a regular vertex
+    Point tangential_update(Vertex v) const;
 
+    Point minimize_squared_areas(Vertex v) const;
+    Point weighted_centroid(Vertex v) const;
+
+    // project all free vertices to the reference surface
+    void project_to_reference();
     void project_to_reference(Vertex v);
+    // move v to p on reference face f, interpolate normal and sizing
+    void interpolate_reference(Vertex v, Face f, const Point& p);
+
+    // can vertex v be moved by smoothing and projection?
+    bool is_free(Vertex v) const
+    {
+        return !mesh_.is_deleted(v) && !mesh_.is_boundary(v) && !vlocked_[v];
+    }
 
     bool is_too_long(Vertex v0, Vertex v1) const
     {
@@ -286,10 +97,18 @@ private:
     }
 
     SurfaceMesh& mesh_;
-    std::shared_ptr<SurfaceMesh> refmesh_;
+
+    // Reference surface for back-projection. Either the reference of the
+    // sizing field or a copy of the input mesh.
+    const SurfaceMesh* refmesh_{nullptr};
+    const BVH* bvh_{nullptr};
+    std::unique_ptr<SurfaceMesh> own_refmesh_;
+    std::unique_ptr<BVH> own_bvh_;
+
+    const SizingField* sizing_field_{nullptr};
+    std::unique_ptr<SizingField> own_sizing_field_;
 
     bool use_projection_;
-    std::unique_ptr<TriangleKdTree> kd_tree_;
 
     bool uniform_;
     Scalar target_edge_length_;
@@ -297,6 +116,16 @@ private:
     Scalar max_edge_length_;
     Scalar approx_error_;
 
+    // Unlocked vertices and edges in index order. All passes only visit these,
+    // such that remeshing a selected region does not touch the rest of the
+    // mesh. Garbage collection is postponed in this case to keep handles of
+    // unaffected elements valid.
+    bool localized_{false};
+    std::vector<Vertex> active_vertices_;
+    std::vector<Edge> active_edges_;
+    size_t n_checked_vertices_{0};
+    size_t n_checked_edges_{0};
+
     bool has_feature_vertices_{false};
     bool has_feature_edges_{false};
     VertexProperty<Point> points_;
@@ -309,11 +138,11 @@ private:
 
     VertexProperty<Point> refpoints_;
     VertexProperty<Point> refnormals_;
-    VertexProperty<Scalar> refsizing_;
+    std::vector<Scalar> refsizing_; // target edge length per reference vertex
 };
 
 Remeshing::Remeshing(SurfaceMesh& mesh)
-    : mesh_(mesh), refmesh_(nullptr), kd_tree_(nullptr)
+    : mesh_(mesh)
 {
     if (!mesh_.is_triangle_mesh())
         throw InvalidInputException("Input is not a triangle mesh!");
@@ -340,7 +169,7 @@ void Remeshing::uniform_remeshing(Scalar edge_length, unsigned int iterations,
     {
         split_long_edges();
 
-        vertex_normals(mesh_);
+        update_vertex_normals();
 
         collapse_short_edges();
 
@@ -356,9 +185,11 @@ void Remeshing::uniform_remeshing(Scalar edge_length, unsigned int iterations,
 
 void Remeshing::adaptive_remeshing(Scalar min_edge_length,
                                    Scalar max_edge_length, Scalar approx_error,
-                                   unsigned int iterations, bool use_projection)
+                                   unsigned int iterations, bool use_projection,
+                                   const SizingField* sizing_field)
 {
     uniform_ = false;
+    sizing_field_ = sizing_field;
     min_edge_length_ = min_edge_length;
     max_edge_length_ = max_edge_length;
     approx_error_ = approx_error;
@@ -370,7 +201,7 @@ void Remeshing::adaptive_remeshing(Scalar min_edge_length,
     {
         split_long_edges();
 
-        vertex_normals(mesh_);
+        update_vertex_normals();
 
         collapse_short_edges();
 
@@ -409,6 +240,7 @@ void Remeshing::preprocessing()
 
         if (has_selection)
         {
+            localized_ = true;
             for (auto v : mesh_.vertices())
             {
                 vlocked_[v] = !vselected[v];
@@ -438,6 +270,8 @@ void Remeshing::preprocessing()
         }
     }
 
+    init_active_elements();
+
     // compute sizing field
     if (uniform_)
     {
@@ -448,131 +282,121 @@ void Remeshing::preprocessing()
     }
     else
     {
-        // compute curvature for all mesh vertices, using cotan or Cohen-Steiner
-        // don't use two-ring neighborhood, since we otherwise compute
-        // curvature over sharp features edges, leading to high curvatures.
-        // prefer tensor analysis over cotan-Laplace, since the former is more
-        // robust and gives better results on the boundary.
-        // don't smooth curvatures here, since it does not take feature edges
-        // into account.
-        curvature(mesh_, Curvature::MaxAbs, 0, true, false);
-        auto curvatures = mesh_.get_vertex_property<Scalar>("v:curv");
-
-        // smooth curvatures while taking feature edges into account
-        for (auto v : mesh_.vertices())
+        // analyze the input mesh itself if no sizing field is given
+        if (!sizing_field_)
         {
-            if (vfeature_ && vfeature_[v])
-                continue;
-            Scalar curv(0), weight, sum_weights(0);
-            for (auto vh : mesh_.halfedges(v))
-            {
-                auto vv = mesh_.to_vertex(vh);
-                if (vfeature_ && vfeature_[vv])
-                    continue;
-                weight = std::max(0.0, cotan_weight(mesh_, mesh_.edge(vh)));
-                sum_weights += weight;
-                curv += weight * curvatures[vv];
-            }
-            if (sum_weights)
-                curvatures[v] = curv / sum_weights;
+            own_sizing_field_ = std::make_unique<SizingField>(mesh_);
+            sizing_field_ = own_sizing_field_.get();
         }
 
-        // use vsizing_ to store/smooth curvatures to avoid another vertex property
-
-        // curvature values for feature vertices and boundary vertices
-        // are not meaningful. mark them as negative values.
-        for (auto v : mesh_.vertices())
+        // target edge lengths of the reference vertices
+        const auto& reference = sizing_field_->reference();
+        auto curvatures = reference.get_vertex_property<Scalar>("v:curv");
+        refsizing_.resize(reference.vertices_size());
+        for (auto v : reference.vertices())
         {
-            if (mesh_.is_boundary(v) || (vfeature_ && vfeature_[v]))
-                vsizing_[v] = -1.0;
-            else
-                vsizing_[v] = curvatures[v];
+            refsizing_[v.idx()] = SizingField::edge_length(
+                curvatures[v], min_edge_length_, max_edge_length_,
+                approx_error_);
         }
 
-        // curvature values might be noisy. smooth them.
-        // don't consider feature vertices' curvatures.
-        // don't consider boundary vertices' curvatures.
-        // do this for two iterations, to propagate curvatures
-        // from non-feature regions to feature vertices.
-        for (int iters = 0; iters < 2; ++iters)
+        if (own_sizing_field_)
         {
+            // the reference is a copy of the mesh
             for (auto v : mesh_.vertices())
             {
-                Scalar w, ww = 0.0;
-                Scalar c, cc = 0.0;
-
-                for (auto h : mesh_.halfedges(v))
-                {
-                    c = vsizing_[mesh_.to_vertex(h)];
-                    if (c > 0.0)
-                    {
-                        w = std::max(0.0, cotan_weight(mesh_, mesh_.edge(h)));
-                        ww += w;
-                        cc += w * c;
-                    }
-                }
-
-                if (ww)
-                    cc /= ww;
-                vsizing_[v] = cc;
+                vsizing_[v] = refsizing_[v.idx()];
             }
         }
-
-        // now convert per-vertex curvature into target edge length
-        for (auto v : mesh_.vertices())
+        else
         {
-            const Scalar c = vsizing_[v];
+            std::vector<Point> queries;
+            for (auto v : mesh_.vertices())
+                queries.push_back(points_[v]);
 
-            // get edge length from curvature
-            const Scalar r = 1.0 / c;
-            const Scalar e = approx_error_;
-            Scalar h;
-            if (e < r)
-            {
-                // see mathworld: "circle segment" and "equilateral triangle"
-                //h = sqrt(2.0*r*e-e*e) * 3.0 / sqrt(3.0);
-                h = sqrt(6.0 * e * r - 3.0 * e * e); // simplified...
-            }
-            else
+            const size_t n = queries.size();
+            std::vector<Face> faces(n);
+            std::vector<Point> nearest(n);
+            std::vector<Scalar> distances(n);
+            sizing_field_->bvh().closest_points(queries, faces, nearest,
+                                                distances);
+
+            size_t i = 0;
+            for (auto v : mesh_.vertices())
             {
-                // this does not really make sense
-                h = e * 3.0 / std::numbers::sqrt3;
+                vsizing_[v] = interpolate(reference, faces[i], nearest[i],
+                                          refsizing_);
+                ++i;
             }
-
-            // clamp to min. and max. edge length
-            if (h < min_edge_length_)
-                h = min_edge_length_;
-            else if (h > max_edge_length_)
-                h = max_edge_length_;
-
-            // store target edge length
-            vsizing_[v] = h;
         }
     }
 
     if (use_projection_)
     {
-        // build reference mesh
-        refmesh_ = std::make_shared<SurfaceMesh>();
-        refmesh_->assign(mesh_);
-        vertex_normals(*refmesh_);
-        refpoints_ = refmesh_->vertex_property<Point>("v:point");
-        refnormals_ = refmesh_->vertex_property<Point>("v:normal");
-
-        // copy sizing field from mesh_
-        refsizing_ = refmesh_->add_vertex_property<Scalar>("v:sizing");
-        for (auto v : refmesh_->vertices())
+        if (sizing_field_)
         {
-            refsizing_[v] = vsizing_[v];
+            // project to the reference surface of the sizing field
+            refmesh_ = &sizing_field_->reference();
+            bvh_ = &sizing_field_->bvh();
+        }
+        else
+        {
+            // build reference mesh
+            own_refmesh_ = std::make_unique<SurfaceMesh>();
+            own_refmesh_->assign(mesh_);
+            vertex_normals(*own_refmesh_);
+            refmesh_ = own_refmesh_.get();
+            refsizing_.assign(refmesh_->vertices_size(), target_edge_length_);
+
+            // build bounding volume hierarchy
+            if (localized_)
+            {
+                // the active region and one ring of faces around it
+                auto fselected =
+                    own_refmesh_->add_face_property<bool>("f:selected");
+                std::vector<Face> faces;
+                for (int ring = 0; ring < 2; ++ring)
+                {
+                    std::vector<Vertex> vertices;
+                    if (ring == 0)
+                        vertices = active_vertices_;
+                    else
+                        for (auto f : faces)
+                            for (auto v : refmesh_->vertices(f))
+                                vertices.push_back(v);
+
+                    for (auto v : vertices)
+                    {
+                        for (auto f : refmesh_->faces(v))
+                        {
+                            if (!fselected[f])
+                            {
+                                fselected[f] = true;
+                                faces.push_back(f);
+                            }
+                        }
+                    }
+                }
+                own_refmesh_->remove_face_property(fselected);
+                own_bvh_ = std::make_unique<BVH>(*refmesh_, faces);
+            }
+            else
+            {
+                own_bvh_ = std::make_unique<BVH>(*refmesh_);
+            }
+            bvh_ = own_bvh_.get();
         }
 
-        // build kd-tree
-        kd_tree_ = std::make_unique<TriangleKdTree>(refmesh_, 0);
+        refpoints_ = refmesh_->get_vertex_property<Point>("v:point");
+        refnormals_ = refmesh_->get_vertex_property<Point>("v:normal");
     }
 }
 
 void Remeshing::postprocessing()
 {
+    if (localized_)
+        mesh_.garbage_collection();
+
     // remove properties
     mesh_.remove_vertex_property(vlocked_);
     mesh_.remove_edge_property(elocked_);
@@ -588,6 +412,97 @@ void Remeshing::postprocessing()
     }
 }
 
+void Remeshing::init_active_elements()
+{
+    active_vertices_.clear();
+    for (auto v : mesh_.vertices())
+        if (!vlocked_[v])
+            active_vertices_.push_back(v);
+
+    active_edges_.clear();
+    for (auto e : mesh_.edges())
+        if (!elocked_[e])
+            active_edges_.push_back(e);
+
+    n_checked_vertices_ = mesh_.vertices_size();
+    n_checked_edges_ = mesh_.edges_size();
+}
+
+void Remeshing::update_active_elements()
+{
+    std::erase_if(active_vertices_,
+                  [this](Vertex v) { return mesh_.is_deleted(v); });
+    for (auto i = n_checked_vertices_; i < mesh_.vertices_size(); ++i)
+    {
+        const Vertex v(i);
+        if (!mesh_.is_deleted(v) && !vlocked_[v])
+            active_vertices_.push_back(v);
+    }
+
+    std::erase_if(active_edges_,
+                  [this](Edge e) { return mesh_.is_deleted(e); });
+    for (auto i = n_checked_edges_; i < mesh_.edges_size(); ++i)
+    {
+        const Edge e(i);
+        if (!mesh_.is_deleted(e) && !elocked_[e])
+            active_edges_.push_back(e);
+    }
+
+    n_checked_vertices_ = mesh_.vertices_size();
+    n_checked_edges_ = mesh_.edges_size();
+}
+
+void Remeshing::update_vertex_normals()
+{
+    update_active_elements();
+
+    const int n = active_vertices_.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < n; ++i)
+    {
+        const Vertex v = active_vertices_[i];
+        vnormal_[v] = vertex_normal(mesh_, v);
+    }
+}
+
+void Remeshing::project_to_reference()
+{
+    if (!use_projection_)
+    {
+        return;
+    }
+
+    // batch query the closest points of all free vertices
+    update_active_elements();
+    std::vector<Vertex> vertices;
+    std::vector<Point> queries;
+    for (auto v : active_vertices_)
+    {
+        if (is_free(v))
+        {
+            vertices.push_back(v);
+            queries.push_back(points_[v]);
+        }
+    }
+
+    const size_t n = vertices.size();
+    std::vector<Face> faces(n);
+    std::vector<Point> nearest(n);
+    std::vector<Scalar> distances(n);
+    bvh_->closest_points(queries, faces, nearest, distances);
+
+    // each vertex only writes its own position, normal, and sizing value
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < int(n); ++i)
+    {
+        interpolate_reference(vertices[i], faces[i], nearest[i]);
+    }
+}
+
 void Remeshing::project_to_reference(Vertex v)
 {
     if (!use_projection_)
@@ -596,23 +511,25 @@ void Remeshing::project_to_reference(Vertex v)
     }
 
     // find closest triangle of reference mesh
-    auto nn = kd_tree_->nearest(points_[v]);
-    const Point p = nn.nearest;
-    const Face f = nn.face;
+    auto nn = bvh_->nearest(points_[v]);
+    interpolate_reference(v, nn.face, nn.nearest);
+}
 
+void Remeshing::interpolate_reference(Vertex v, Face f, const Point& p)
+{
     // get face data
     auto fv = refmesh_->vertices(f);
     const Point p0 = refpoints_[*fv];
     const Point n0 = refnormals_[*fv];
-    const Scalar s0 = refsizing_[*fv];
+    const Scalar s0 = refsizing_[(*fv).idx()];
     ++fv;
     const Point p1 = refpoints_[*fv];
     const Point n1 = refnormals_[*fv];
-    const Scalar s1 = refsizing_[*fv];
+    const Scalar s1 = refsizing_[(*fv).idx()];
     ++fv;
     const Point p2 = refpoints_[*fv];
     const Point n2 = refnormals_[*fv];
-    const Scalar s2 = refsizing_[*fv];
+    const Scalar s2 = refsizing_[(*fv).idx()];
 
     // get barycentric coordinates
     Point b = barycentric_coordinates(p, p0, p1, p2);
@@ -641,19 +558,22 @@ void Remeshing::split_long_edges()
 {
     Vertex vnew, v0, v1;
     Edge enew;
-    bool ok, is_feature, is_boundary;
-    int i;
+    bool is_feature, is_boundary;
 
-    for (ok = false, i = 0; !ok && i < 10; ++i)
-    {
-        ok = true;
+    // Splitting only changes the edges incident to the new vertex, hence only
+    // these have to be checked again in the next round.
+    update_active_elements();
+    std::vector<Edge> edges = active_edges_;
+    std::vector<Edge> next;
 
-        for (auto e : mesh_.edges())
+    for (int i = 0; !edges.empty() && i < 10; ++i)
+    {
+        for (auto e : edges)
         {
             v0 = mesh_.vertex(e, 0);
             v1 = mesh_.vertex(e, 1);
 
-            if (!elocked_[e] && is_too_long(v0, v1))
+            if (is_too_long(v0, v1))
             {
                 const Point& p0 = points_[v0];
                 const Point& p1 = points_[v1];
@@ -670,8 +590,8 @@ void Remeshing::split_long_edges()
 
                 if (is_feature)
                 {
-                    enew = is_boundary ? Edge(mesh_.n_edges() - 2)
-                                       : Edge(mesh_.n_edges() - 3);
+                    enew = is_boundary ? Edge(mesh_.edges_size() - 2)
+                                       : Edge(mesh_.edges_size() - 3);
                     efeature_[enew] = true;
                     vfeature_[vnew] = true;
                 }
@@ -680,9 +600,14 @@ void Remeshing::split_long_edges()
                     project_to_reference(vnew);
                 }
 
-                ok = false;
+                for (auto h : mesh_.halfedges(vnew))
+                    next.push_back(mesh_.edge(h));
             }
         }
+
+        std::ranges::sort(next);
+        edges.assign(next.begin(), std::ranges::unique(next).begin());
+        next.clear();
     }
 }
 
@@ -690,17 +615,79 @@ void Remeshing::collapse_short_edges()
 {
     Vertex v0, v1;
     Halfedge h0, h1, h01, h10;
-    bool ok, b0, b1, l0, l1, f0, f1;
-    int i;
+    bool b0, b1, l0, l1, f0, f1;
     bool hcol01, hcol10;
 
-    for (ok = false, i = 0; !ok && i < 10; ++i)
-    {
-        ok = true;
+    // Edges are visited in index order in each round. A collapse into vertex
+    // v changes the one-rings of v and its neighbors, which might make a
+    // collapse of an edge of their faces possible. Such edges are visited
+    // later in the current round if their index is larger than the one of
+    // the collapsed edge, and in the next round otherwise.
+    update_active_elements();
+    std::vector<Edge> edges = active_edges_;
+    std::vector<Edge> next;
+    std::priority_queue<Edge, std::vector<Edge>, std::greater<>> later;
+
+    // is an edge scheduled for the current or the next round?
+    std::vector<char> is_pending(mesh_.edges_size(), false);
+    std::vector<char> is_next(mesh_.edges_size(), false);
+    for (auto e : edges)
+        is_pending[e.idx()] = true;
+
+    auto schedule = [&](Edge e, Edge current) {
+        if (elocked_[e])
+            return;
+        if (e > current)
+        {
+            if (!is_pending[e.idx()])
+            {
+                is_pending[e.idx()] = true;
+                later.push(e);
+            }
+        }
+        else if (!is_next[e.idx()])
+        {
+            is_next[e.idx()] = true;
+            next.push_back(e);
+        }
+    };
+
+    auto touch = [&](Vertex v, Edge current) {
+        for (auto h : mesh_.halfedges(v))
+        {
+            const Vertex vv = mesh_.to_vertex(h);
+            for (auto hh : mesh_.halfedges(vv))
+            {
+                schedule(mesh_.edge(hh), current);
+                schedule(mesh_.edge(mesh_.next_halfedge(hh)), current);
+            }
+        }
+        for (auto h : mesh_.halfedges(v))
+        {
+            schedule(mesh_.edge(h), current);
+            schedule(mesh_.edge(mesh_.next_halfedge(h)), current);
+        }
+    };
 
-        for (auto e : mesh_.edges())
+    for (int i = 0; !edges.empty() && i < 10; ++i)
+    {
+        size_t j = 0;
+        while (j < edges.size() || !later.empty())
         {
-            if (!mesh_.is_deleted(e) && !elocked_[e])
+            // next edge in index order
+            Edge e;
+            if (later.empty() || (j < edges.size() && edges[j] < later.top()))
+            {
+                e = edges[j++];
+            }
+            else
+            {
+                e = later.top();
+                later.pop();
+            }
+            is_pending[e.idx()] = false;
+
+            if (!mesh_.is_deleted(e))
             {
                 h10 = mesh_.halfedge(e, 0);
                 h01 = mesh_.halfedge(e, 1);
@@ -795,7 +782,7 @@ void Remeshing::collapse_short_edges()
                         if (hcol10)
                         {
                             mesh_.collapse(h10);
-                            ok = false;
+                            touch(v0, e);
                         }
                     }
 
@@ -815,15 +802,28 @@ void Remeshing::collapse_short_edges()
                         if (hcol01)
                         {
                             mesh_.collapse(h01);
-                            ok = false;
+                            touch(v1, e);
                         }
                     }
                 }
             }
         }
+
+        std::ranges::sort(next);
+        edges.swap(next);
+        next.clear();
+        for (auto e : edges)
+        {
+            is_next[e.idx()] = false;
+            is_pending[e.idx()] = true;
+        }
     }
 
-    mesh_.garbage_collection();
+    if (!localized_)
+    {
+        mesh_.garbage_collection();
+        init_active_elements();
+    }
 }
 
 void Remeshing::flip_edges()
@@ -837,8 +837,9 @@ void Remeshing::flip_edges()
     int i;
 
     // precompute valences
+    update_active_elements();
     auto valence = mesh_.add_vertex_property<int>("valence");
-    for (auto v : mesh_.vertices())
+    for (auto v : active_vertices_)
     {
         valence[v] = mesh_.valence(v);
     }
@@ -847,9 +848,9 @@ void Remeshing::flip_edges()
     {
         ok = true;
 
-        for (auto e : mesh_.edges())
+        for (auto e : active_edges_)
         {
-            if (!elocked_[e] && !efeature_[e])
+            if (!efeature_[e])
             {
                 h = mesh_.halfedge(e, 0);
                 v0 = mesh_.to_vertex(h);
@@ -919,124 +920,114 @@ void Remeshing::flip_edges()
 
 void Remeshing::tangential_smoothing(unsigned int iterations)
 {
-    Vertex vv;
-    Scalar w, ww;
-    Point u, n, t, b;
-
-    // add property
-    auto update = mesh_.add_vertex_property<Point>("v:update");
-
     // project at the beginning to get valid sizing values and normal vectors
     // for vertices introduced by splitting
-    if (use_projection_)
-    {
-        for (auto v : mesh_.vertices())
-        {
-            if (!mesh_.is_boundary(v) && !vlocked_[v])
-            {
-                project_to_reference(v);
-            }
-        }
-    }
+    project_to_reference();
+
+    const int n = active_vertices_.size();
+    std::vector<Point> update(n);
 
     for (unsigned int iters = 0; iters < iterations; ++iters)
     {
-        for (auto v : mesh_.vertices())
+        // compute updates from the current positions. each vertex only
+        // writes its own update, hence vertices are processed in parallel.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+        for (int i = 0; i < n; ++i)
         {
-            if (!mesh_.is_boundary(v) && !vlocked_[v])
+            const Vertex v = active_vertices_[i];
+            if (is_free(v))
             {
                 if (vfeature_[v])
-                {
-                    u = Point(0.0);
-                    t = Point(0.0);
-                    ww = 0;
-                    int c = 0;
-
-                    for (auto h : mesh_.halfedges(v))
-                    {
-                        if (efeature_[mesh_.edge(h)])
-                        {
-                            vv = mesh_.to_vertex(h);
-
-                            b = points_[v];
-                            b += points_[vv];
-                            b *= 0.5;
-
-                            w = distance(points_[v], points_[vv]) /
-                                (0.5 * (vsizing_[v] + vsizing_[vv]));
-                            ww += w;
-                            u += w * b;
-
-                            if (c == 0)
-                            {
-                                t += normalize(points_[vv] - points_[v]);
-                                ++c;
-                            }
-                            else
-                            {
-                                ++c;
-                                t -= normalize(points_[vv] - points_[v]);
-                            }
-                        }
-                    }
-
-                    assert(c == 2);
-
-                    u *= (1.0 / ww);
-                    u -= points_[v];
-                    t = normalize(t);
-                    u = t * dot(u, t);
-
-                    update[v] = u;
-                }
+                    update[i] = feature_update(v);
                 else
-                {
-                    Point p(0);
-                    try
-                    {
-                        p = minimize_squared_areas(v);
-                    }
-                    catch (SolverException&)
-                    {
-                        p = weighted_centroid(v);
-                    }
-                    u = p - mesh_.position(v);
-
-                    n = vnormal_[v];
-                    u -= n * dot(u, n);
-
-                    update[v] = u;
-                }
+                    update[i] = tangential_update(v);
             }
         }
 
         // update vertex positions
-        for (auto v : mesh_.vertices())
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < n; ++i)
         {
-            if (!mesh_.is_boundary(v) && !vlocked_[v])
+            const Vertex v = active_vertices_[i];
+            if (is_free(v))
             {
-                points_[v] += update[v];
+                points_[v] += update[i];
             }
         }
 
         // update normal vectors (if not done so through projection)
-        vertex_normals(mesh_);
+        update_vertex_normals();
     }
 
     // project at the end
-    if (use_projection_)
+    project_to_reference();
+}
+
+Point Remeshing::feature_update(Vertex v) const
+{
+    Point u(0.0), t(0.0), b;
+    Scalar w, ww = 0;
+    int c = 0;
+
+    for (auto h : mesh_.halfedges(v))
     {
-        for (auto v : mesh_.vertices())
+        if (efeature_[mesh_.edge(h)])
         {
-            if (!mesh_.is_boundary(v) && !vlocked_[v])
+            const Vertex vv = mesh_.to_vertex(h);
+
+            b = points_[v];
+            b += points_[vv];
+            b *= 0.5;
+
+            w = distance(points_[v], points_[vv]) /
+                (0.5 * (vsizing_[v] + vsizing_[vv]));
+            ww += w;
+            u += w * b;
+
+            if (c == 0)
             {
-                project_to_reference(v);
+                t += normalize(points_[vv] - points_[v]);
+                ++c;
+            }
+            else
+            {
+                ++c;
+                t -= normalize(points_[vv] - points_[v]);
             }
         }
     }
 
-    // remove property
-    mesh_.remove_vertex_property(update);
+    assert(c == 2);
+
+    u *= (1.0 / ww);
+    u -= points_[v];
+    t = normalize(t);
+    u = t * dot(u, t);
+
+    return u;
+}
+
+Point Remeshing::tangential_update(Vertex v) const
+{
+    Point p(0);
+    try
+    {
+        p = minimize_squared_areas(v);
+    }
+    catch (SolverException&)
+    {
+        p = weighted_centroid(v);
+    }
+    Point u = p - mesh_.position(v);
+
+    const Point n = vnormal_[v];
+    u -= n * dot(u, n);
+
+    return u;
 }
 
 void Remeshing::remove_caps()
@@ -1047,9 +1038,10 @@ void Remeshing::remove_caps()
     const Scalar aa(::cos(170.0 * std::numbers::pi / 180.0));
     Point a, b, c, d;
 
-    for (auto e : mesh_.edges())
+    update_active_elements();
+    for (auto e : active_edges_)
     {
-        if (!elocked_[e] && mesh_.is_flip_ok(e))
+        if (mesh_.is_flip_ok(e))
         {
             h = mesh_.halfedge(e, 0);
             a = points_[mesh_.to_vertex(h)];
@@ -1095,7 +1087,7 @@ void Remeshing::remove_caps()
     }
 }
 
-Point Remeshing::minimize_squared_areas(Vertex v)
+Point Remeshing::minimize_squared_areas(Vertex v) const
 {
     dmat3 A(0);
     dvec3 b(0), x;
@@ -1140,7 +1132,7 @@ Point Remeshing::minimize_squared_areas(Vertex v)
     return Point(x);
 }
 
-Point Remeshing::weighted_centroid(Vertex v)
+Point Remeshing::weighted_centroid(Vertex v) const
 {
     auto p = Point(0);
     double ww = 0;
@@ -1177,6 +1169,165 @@ Point Remeshing::weighted_centroid(Vertex v)
 }
 } // namespace
 
+SizingField::SizingField(const SurfaceMesh& mesh)
+{
+    if (!mesh.is_triangle_mesh())
+        throw InvalidInputException("Input is not a triangle mesh!");
+
+    // copy geometry, connectivity, and features
+    reference_.assign(mesh);
+    auto vfeature = mesh.get_vertex_property<bool>("v:feature");
+    auto efeature = mesh.get_edge_property<bool>("e:feature");
+    if (vfeature)
+    {
+        auto feature = reference_.add_vertex_property<bool>("v:feature");
+        for (auto v : reference_.vertices())
+            feature[v] = vfeature[v];
+        vfeature = feature;
+    }
+    if (efeature)
+    {
+        auto feature = reference_.add_edge_property<bool>("e:feature");
+        for (auto e : reference_.edges())
+            feature[e] = efeature[e];
+    }
+
+    vertex_normals(reference_);
+
+    // compute curvature for all mesh vertices, using cotan or Cohen-Steiner
+    // don't use two-ring neighborhood, since we otherwise compute
+    // curvature over sharp features edges, leading to high curvatures.
+    // prefer tensor analysis over cotan-Laplace, since the former is more
+    // robust and gives better results on the boundary.
+    // don't smooth curvatures here, since it does not take feature edges
+    // into account.
+    pmp::curvature(reference_, Curvature::MaxAbs, 0, true, false);
+    curvature_ = reference_.get_vertex_property<Scalar>("v:curv");
+
+    // smooth curvatures while taking feature edges into account
+    for (auto v : reference_.vertices())
+    {
+        if (vfeature && vfeature[v])
+            continue;
+        Scalar curv(0), weight, sum_weights(0);
+        for (auto vh : reference_.halfedges(v))
+        {
+            auto vv = reference_.to_vertex(vh);
+            if (vfeature && vfeature[vv])
+                continue;
+            weight =
+                std::max(0.0, cotan_weight(reference_, reference_.edge(vh)));
+            sum_weights += weight;
+            curv += weight * curvature_[vv];
+        }
+        if (sum_weights)
+            curvature_[v] = curv / sum_weights;
+    }
+
+    // curvature values for feature vertices and boundary vertices
+    // are not meaningful. mark them as negative values.
+    for (auto v : reference_.vertices())
+    {
+        if (reference_.is_boundary(v) || (vfeature && vfeature[v]))
+            curvature_[v] = -1.0;
+    }
+
+    // curvature values might be noisy. smooth them.
+    // don't consider feature vertices' curvatures.
+    // don't consider boundary vertices' curvatures.
+    // do this for two iterations, to propagate curvatures
+    // from non-feature regions to feature vertices.
+    for (int iters = 0; iters < 2; ++iters)
+    {
+        for (auto v : reference_.vertices())
+        {
+            Scalar w, ww = 0.0;
+            Scalar c, cc = 0.0;
+
+            for (auto h : reference_.halfedges(v))
+            {
+                c = curvature_[reference_.to_vertex(h)];
+                if (c > 0.0)
+                {
+                    w = std::max(0.0,
+                                 cotan_weight(reference_, reference_.edge(h)));
+                    ww += w;
+                    cc += w * c;
+                }
+            }
+
+            if (ww)
+                cc /= ww;
+            curvature_[v] = cc;
+        }
+    }
+
+    bvh_ = std::make_unique<BVH>(reference_);
+}
+
+Scalar SizingField::curvature(const Point& p) const
+{
+    const auto nn = bvh_->nearest(p);
+    Scalar c[3];
+    Point q[3];
+    int i = 0;
+    for (auto v : reference_.vertices(nn.face))
+    {
+        c[i] = curvature_[v];
+        q[i] = reference_.position(v);
+        ++i;
+    }
+    const Point b = barycentric_coordinates(nn.nearest, q[0], q[1], q[2]);
+    return b[0] * c[0] + b[1] * c[1] + b[2] * c[2];
+}
+
+Scalar SizingField::edge_length(const Point& p, Scalar min_edge_length,
+                                Scalar max_edge_length,
+                                Scalar approx_error) const
+{
+    const auto nn = bvh_->nearest(p);
+    Scalar h[3];
+    Point q[3];
+    int i = 0;
+    for (auto v : reference_.vertices(nn.face))
+    {
+        h[i] = edge_length(curvature_[v], min_edge_length, max_edge_length,
+                           approx_error);
+        q[i] = reference_.position(v);
+        ++i;
+    }
+    const Point b = barycentric_coordinates(nn.nearest, q[0], q[1], q[2]);
+    return b[0] * h[0] + b[1] * h[1] + b[2] * h[2];
+}
+
+Scalar SizingField::edge_length(Scalar curvature, Scalar min_edge_length,
+                                Scalar max_edge_length, Scalar approx_error)
+{
+    // get edge length from curvature
+    const Scalar r = 1.0 / curvature;
+    const Scalar e = approx_error;
+    Scalar h;
+    if (e < r)
+    {
+        // see mathworld: "circle segment" and "equilateral triangle"
+        //h = sqrt(2.0*r*e-e*e) * 3.0 / sqrt(3.0);
+        h = sqrt(6.0 * e * r - 3.0 * e * e); // simplified...
+    }
+    else
+    {
+        // this does not really make sense
+        h = e * 3.0 / std::numbers::sqrt3;
+    }
+
+    // clamp to min. and max. edge length
+    if (h < min_edge_length)
+        h = min_edge_length;
+    else if (h > max_edge_length)
+        h = max_edge_length;
+
+    return h;
+}
+
 void uniform_remeshing(SurfaceMesh& mesh, Scalar edge_length,
                        unsigned int iterations, bool use_projection)
 {
@@ -1192,4 +1343,14 @@ void adaptive_remeshing(SurfaceMesh& mesh, Scalar min_edge_length,
                                        use_projection);
 }
 
+void adaptive_remeshing(SurfaceMesh& mesh, const SizingField& sizing_field,
+                        Scalar min_edge_length, Scalar max_edge_length,
+                        Scalar approx_error, unsigned int iterations,
+                        bool use_projection)
+{
+    Remeshing(mesh).adaptive_remeshing(min_edge_length, max_edge_length,
+                                       approx_error, iterations,
+                                       use_projection, &sizing_field);
+}
+
 } // namespace pmp
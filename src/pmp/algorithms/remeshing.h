@@ -3,10 +3,58 @@
 
 #pragma once
 
+#include <memory>
+
 #include "pmp/surface_mesh.h"
+#include "pmp/algorithms/bvh.h"
 
 namespace pmp {
 
+//! \brief Curvature-based sizing field for adaptive remeshing.
+//! \details Analyzes the curvature of a reference mesh once, taking its
+//! feature edges into account. The target edge length at a point is derived
+//! from the curvature at its closest point on the reference surface. Passing
+//! the same sizing field to several calls of adaptive_remeshing() avoids
+//! repeating this analysis, e.g., when remeshing the same input with different
+//! error bounds. All queries can be issued concurrently from multiple threads.
+//! \ingroup algorithms
+class SizingField
+{
+public:
+    //! \brief Analyze the curvature of \p mesh.
+    //! \pre Input mesh needs to be a triangle mesh.
+    //! \throw InvalidInputException if the input precondition is violated.
+    explicit SizingField(const SurfaceMesh& mesh);
+
+    //! \brief Curvature at the closest point to \p p on the reference surface.
+    Scalar curvature(const Point& p) const;
+
+    //! \brief Target edge length at the closest point to \p p on the reference
+    //! surface.
+    //! \param p The query point.
+    //! \param min_edge_length The minimum edge length.
+    //! \param max_edge_length The maximum edge length.
+    //! \param approx_error The maximum approximation error.
+    Scalar edge_length(const Point& p, Scalar min_edge_length,
+                       Scalar max_edge_length, Scalar approx_error) const;
+
+    //! \brief Target edge length for a given \p curvature.
+    static Scalar edge_length(Scalar curvature, Scalar min_edge_length,
+                              Scalar max_edge_length, Scalar approx_error);
+
+    //! \brief The reference mesh, with vertex normals `v:normal` and smoothed
+    //! curvatures `v:curv`.
+    const SurfaceMesh& reference() const { return reference_; }
+
+    //! \brief The bounding volume hierarchy of the reference mesh.
+    const BVH& bvh() const { return *bvh_; }
+
+private:
+    SurfaceMesh reference_;
+    VertexProperty<Scalar> curvature_;
+    std::unique_ptr<BVH> bvh_;
+};
+
 //! \brief Perform uniform remeshing.
 //! \details Performs incremental remeshing based
 //! on edge collapse, split, flip, and tangential relaxation.
@@ -40,4 +88,22 @@ void adaptive_remeshing(SurfaceMesh& mesh, Scalar min_edge_length,
                         unsigned int iterations = 10,
                         bool use_projection = true);
 
+//! \brief Perform adaptive remeshing using a precomputed sizing field.
+//! \details Same as above, but the target edge lengths are taken from
+//! \p sizing_field, and vertices are projected to its reference surface.
+//! \param mesh The input mesh, modified in place.
+//! \param sizing_field The sizing field.
+//! \param min_edge_length The minimum edge length.
+//! \param max_edge_length The maximum edge length.
+//! \param approx_error The maximum approximation error.
+//! \param iterations The number of iterations.
+//! \param use_projection Use back-projection to the reference surface.
+//! \pre Input mesh needs to be a triangle mesh.
+//! \throw InvalidInputException if the input precondition is violated.
+//! \ingroup algorithms
+void adaptive_remeshing(SurfaceMesh& mesh, const SizingField& sizing_field,
+                        Scalar min_edge_length, Scalar max_edge_length,
+                        Scalar approx_error, unsigned int iterations = 10,
+                        bool use_projection = true);
+
 } // namespace pmp
@@ -4,8 +4,32 @@
 #include "pmp/algorithms/smoothing.h"
 #include "pmp/algorithms/differential_geometry.h"
 #include "pmp/algorithms/laplace.h"
+#include "pmp/algorithms/multigrid.h"
+
+#include <exception>
+#include <optional>
 
 namespace pmp {
+namespace {
+
+// restore surface area and center after a smoothing step
+void restore_area_and_center(SurfaceMesh& mesh, Scalar area_before,
+                             const Point& center_before)
+{
+    // restore original surface area
+    const Scalar area_after = surface_area(mesh);
+    const Scalar scale = sqrt(area_before / area_after);
+    for (auto v : mesh.vertices())
+        mesh.position(v) *= scale;
+
+    // restore original center
+    const Point center_after = centroid(mesh);
+    const Point trans = center_before - center_after;
+    for (auto v : mesh.vertices())
+        mesh.position(v) += trans;
+}
+
+} // namespace
 
 void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations,
                         bool use_uniform_laplace)
@@ -13,6 +37,16 @@ void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations,
     if (!mesh.n_vertices())
         return;
 
+    // move each vertex halfway towards the weighted average of its neighbors
+    ExplicitSmoother smoother(mesh, use_uniform_laplace);
+    smoother.smooth(iterations, 0.5);
+    smoother.write(mesh);
+}
+
+ExplicitSmoother::ExplicitSmoother(const SurfaceMesh& mesh,
+                                   bool use_uniform_laplace)
+    : n_vertices_(mesh.n_vertices())
+{
     // Laplace matrix (clamp negative cotan weights to zero)
     SparseMatrix L;
     if (use_uniform_laplace)
@@ -20,33 +54,161 @@ void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations,
     else
         laplace_matrix(mesh, L, true);
 
-    // normalize each row by sum of weights
-    // scale by 0.5 to make it more robust
-    // multiply by -1 to make it neg. definite again
-    const DiagonalMatrix D = -0.5 * L.diagonal().asDiagonal().inverse();
-    L = D * L;
+    // L is symmetric, such that its columns are the rows of W. Normalize each
+    // row by the sum of its weights.
+    row_offsets_.reserve(n_vertices_ + 1);
+    columns_.reserve(L.nonZeros());
+    weights_.reserve(L.nonZeros());
+    row_offsets_.push_back(0);
+    for (unsigned int i = 0; i < n_vertices_; ++i)
+    {
+        const double sum_weights = -L.coeff(i, i);
+        if (mesh.is_boundary(Vertex(i)) || !(sum_weights > 0.0))
+        {
+            columns_.push_back(i);
+            weights_.push_back(1);
+        }
+        else
+        {
+            for (SparseMatrix::InnerIterator iter(L, i); iter; ++iter)
+            {
+                if (iter.row() != Eigen::Index(i) && iter.value() != 0.0)
+                {
+                    columns_.push_back(iter.row());
+                    weights_.push_back(iter.value() / sum_weights);
+                }
+            }
+        }
+        row_offsets_.push_back(columns_.size());
+    }
+
+    read(mesh);
+}
 
-    // cancel out boundary vertices
-    SparseMatrix S;
-    auto is_inner = [&](Vertex v) { return !mesh.is_boundary(v); };
-    selector_matrix(mesh, is_inner, S);
-    L = S.transpose() * S * L;
+void ExplicitSmoother::read(const SurfaceMesh& mesh)
+{
+    if (mesh.n_vertices() != n_vertices_)
+    {
+        auto what = std::string{__func__} + ": Number of vertices differs.";
+        throw InvalidInputException(what);
+    }
+
+    const unsigned int n = n_vertices_;
+    positions_.resize(3 * n);
+    for (auto v : mesh.vertices())
+        for (unsigned int j = 0; j < 3; ++j)
+            positions_[j * n + v.idx()] = mesh.position(v)[j];
+    original_ = positions_;
+}
+
+void ExplicitSmoother::write(SurfaceMesh& mesh) const
+{
+    if (mesh.n_vertices() != n_vertices_)
+    {
+        auto what = std::string{__func__} + ": Number of vertices differs.";
+        throw InvalidInputException(what);
+    }
 
-    // copy vertex coordinates to matrix
-    DenseMatrix X;
-    coordinates_to_matrix(mesh, X);
+    const unsigned int n = n_vertices_;
+    for (auto v : mesh.vertices())
+        for (unsigned int j = 0; j < 3; ++j)
+            mesh.position(v)[j] = positions_[j * n + v.idx()];
+}
+
+void ExplicitSmoother::smooth(unsigned int iterations, Scalar lambda)
+{
+    for (unsigned int iter = 0; iter < iterations; ++iter)
+    {
+        apply(positions_, buffer_, 1, lambda);
+        positions_.swap(buffer_);
+    }
+}
+
+void ExplicitSmoother::taubin_smooth(unsigned int iterations, Scalar lambda,
+                                     Scalar mu)
+{
+    for (unsigned int iter = 0; iter < iterations; ++iter)
+    {
+        apply(positions_, buffer_, 1, lambda);
+        apply(buffer_, positions_, 1, mu);
+    }
+}
+
+void ExplicitSmoother::hc_smooth(unsigned int iterations, Scalar alpha,
+                                 Scalar beta)
+{
+    const int size = positions_.size();
+    difference_.resize(size);
+
+    for (unsigned int iter = 0; iter < iterations; ++iter)
+    {
+        // Laplacian step p = W q of the previous positions q
+        apply(positions_, buffer_, 1, 1);
+
+        // b = p - (alpha o + (1 - alpha) q) for the original positions o
+        const Scalar* o = original_.data();
+        const Scalar* q = positions_.data();
+        const Scalar* p = buffer_.data();
+        Scalar* b = difference_.data();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int i = 0; i < size; ++i)
+            b[i] = p[i] - (alpha * o[i] + (1 - alpha) * q[i]);
+
+        // push back by beta b + (1 - beta) W b
+        apply(difference_, positions_, -1, beta - 1, 1, &buffer_);
+    }
+}
+
+void ExplicitSmoother::apply(const std::vector<Scalar>& in,
+                             std::vector<Scalar>& out, Scalar a, Scalar c,
+                             Scalar d, const std::vector<Scalar>* base) const
+{
+    const int n = n_vertices_;
+    out.resize(3 * n);
+    if (!base)
+    {
+        base = &in;
+        d = 0;
+    }
 
-    // perform some iterations
-    for (unsigned int i = 0; i < iterations; ++i)
-        X += L * X;
+    const unsigned int* offsets = row_offsets_.data();
+    const unsigned int* columns = columns_.data();
+    const Scalar* weights = weights_.data();
+    const Scalar* x = in.data();
+    const Scalar* y = x + n;
+    const Scalar* z = y + n;
+    const Scalar* bx = base->data();
+    const Scalar* by = bx + n;
+    const Scalar* bz = by + n;
+    Scalar* ox = out.data();
+    Scalar* oy = ox + n;
+    Scalar* oz = oy + n;
 
-    // copy matrix back to vertex coordinates
-    matrix_to_coordinates(X, mesh);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int i = 0; i < n; ++i)
+    {
+        Scalar sx = 0, sy = 0, sz = 0;
+        for (unsigned int k = offsets[i]; k < offsets[i + 1]; ++k)
+        {
+            const unsigned int j = columns[k];
+            const Scalar w = weights[k];
+            sx += w * x[j];
+            sy += w * y[j];
+            sz += w * z[j];
+        }
+        ox[i] = a * x[i] + c * (sx - x[i]) + d * bx[i];
+        oy[i] = a * y[i] + c * (sy - y[i]) + d * by[i];
+        oz[i] = a * z[i] + c * (sz - z[i]) + d * bz[i];
+    }
 }
 
 void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep,
                         unsigned int iterations, bool use_uniform_laplace,
-                        bool rescale)
+                        bool rescale, LinearSolver solver)
 {
     if (!mesh.n_vertices())
         return;
@@ -60,6 +222,43 @@ void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep,
         area_before = surface_area(mesh);
     }
 
+    auto is_constrained = [&](unsigned int i) {
+        return mesh.is_boundary(Vertex(i));
+    };
+
+    // matrix-free solver for the system (M - timestep * L) X = M X
+    if (solver == LinearSolver::ConjugateGradient)
+    {
+        const LaplaceOperator L(mesh, use_uniform_laplace);
+        const Eigen::VectorXd Ldiag = L.diagonal();
+        DiagonalMatrix M;
+        DenseMatrix X, B, LX;
+
+        for (unsigned int iter = 0; iter < iterations; ++iter)
+        {
+            if (use_uniform_laplace)
+                uniform_mass_matrix(mesh, M);
+            else
+                mass_matrix(mesh, M);
+
+            auto A = [&](const DenseMatrix& x, DenseMatrix& y) {
+                L.multiply(x, LX);
+                y = M * x - timestep * LX;
+            };
+            const Eigen::VectorXd diagonal = M.diagonal() - timestep * Ldiag;
+
+            // use current positions as initial guess
+            coordinates_to_matrix(mesh, X);
+            B = M * X;
+            conjugate_gradient_solve(A, diagonal, B, X, is_constrained);
+            matrix_to_coordinates(X, mesh);
+
+            if (rescale)
+                restore_area_and_center(mesh, area_before, center_before);
+        }
+        return;
+    }
+
     // build system matrix A (clamp negative cotan weights to zero)
     SparseMatrix L;
     DiagonalMatrix M;
@@ -76,6 +275,18 @@ void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep,
     SparseMatrix A = SparseMatrix(M) - timestep * L;
     DenseMatrix X, B;
 
+    // neither the constraints nor the sparsity pattern of A change between
+    // iterations
+    const auto precision = solver == LinearSolver::MixedPrecision
+                               ? FactorizationPrecision::Single
+                               : FactorizationPrecision::Double;
+    ConstrainedSolver cholesky(mesh.n_vertices(), is_constrained, precision);
+
+    // the mesh hierarchy does not change between iterations
+    std::optional<MultigridSolver> multigrid;
+    if (solver == LinearSolver::Multigrid)
+        multigrid.emplace(mesh);
+
     for (unsigned int iter = 0; iter < iterations; ++iter)
     {
         if (!use_uniform_laplace)
@@ -89,27 +300,190 @@ void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep,
         B = M * X;
 
         // solve system
-        auto is_constrained = [&](unsigned int i) {
-            return mesh.is_boundary(Vertex(i));
-        };
-        X = cholesky_solve(A, B, is_constrained, X);
+        if (multigrid)
+        {
+            multigrid->compute(A, is_constrained);
+            multigrid->solve(B, X);
+        }
+        else
+        {
+            X = cholesky.solve(A, B, X);
+        }
         matrix_to_coordinates(X, mesh);
 
         if (rescale)
+            restore_area_and_center(mesh, area_before, center_before);
+    }
+}
+
+void implicit_smoothing(const SurfaceMesh& mesh,
+                        std::vector<std::vector<Point>>& frames,
+                        Scalar timestep, unsigned int iterations,
+                        bool use_uniform_laplace, bool rescale)
+{
+    check_frames(mesh, frames, __func__);
+    if (!mesh.n_vertices() || frames.empty())
+        return;
+
+    const int n = mesh.n_vertices();
+    const int n_frames = frames.size();
+    auto is_constrained = [&](unsigned int i) {
+        return mesh.is_boundary(Vertex(i));
+    };
+
+    // the first exception thrown in a parallel region, rethrown afterwards
+    std::exception_ptr exception;
+
+    if (use_uniform_laplace)
+    {
+        // the system matrix only depends on the connectivity: factorize
+        // once and solve for blocks of frames at once
+        SparseMatrix L;
+        DiagonalMatrix M;
+        uniform_laplace_matrix(mesh, L);
+        uniform_mass_matrix(mesh, M);
+        ConstrainedSolver cholesky(n, is_constrained);
+        cholesky.factorize(SparseMatrix(M) - timestep * L);
+
+        const int block_size = 16;
+        const int n_blocks = (n_frames + block_size - 1) / block_size;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
         {
-            // restore original surface area
-            const Scalar area_after = surface_area(mesh);
-            const Scalar scale = sqrt(area_before / area_after);
-            for (auto v : mesh.vertices())
-                mesh.position(v) *= scale;
-
-            // restore original center
-            const Point center_after = centroid(mesh);
-            const Point trans = center_before - center_after;
-            for (auto v : mesh.vertices())
-                mesh.position(v) += trans;
+            SurfaceMesh frame_mesh; // for re-scaling
+            if (rescale)
+                frame_mesh = mesh;
+            std::vector<Scalar> areas(block_size);
+            std::vector<Point> centers(block_size);
+            DenseMatrix X, B;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for (int b = 0; b < n_blocks; ++b)
+            {
+                try
+                {
+                    const int begin = b * block_size;
+                    const int size = std::min(block_size, n_frames - begin);
+
+                    // one frame per three columns
+                    X.resize(n, 3 * size);
+                    for (int f = 0; f < size; ++f)
+                    {
+                        const auto& frame = frames[begin + f];
+                        for (int i = 0; i < n; ++i)
+                            for (int j = 0; j < 3; ++j)
+                                X(i, 3 * f + j) = frame[i][j];
+                        if (rescale)
+                        {
+                            frame_mesh.positions() = frame;
+                            areas[f] = surface_area(frame_mesh);
+                            centers[f] = centroid(frame_mesh);
+                        }
+                    }
+
+                    for (unsigned int iter = 0; iter < iterations; ++iter)
+                    {
+                        B = M * X;
+                        X = cholesky.solve(B, X);
+
+                        if (rescale)
+                        {
+                            for (int f = 0; f < size; ++f)
+                            {
+                                matrix_to_coordinates(X.middleCols(3 * f, 3),
+                                                      frame_mesh);
+                                restore_area_and_center(frame_mesh, areas[f],
+                                                        centers[f]);
+                                coordinates_to_matrix(frame_mesh, B);
+                                X.middleCols(3 * f, 3) = B;
+                            }
+                        }
+                    }
+
+                    for (int f = 0; f < size; ++f)
+                    {
+                        auto& frame = frames[begin + f];
+                        for (int i = 0; i < n; ++i)
+                            for (int j = 0; j < 3; ++j)
+                                frame[i][j] = X(i, 3 * f + j);
+                    }
+                }
+                catch (...)
+                {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    if (!exception)
+                        exception = std::current_exception();
+                }
+            }
+        }
+    }
+    else
+    {
+        // the system matrix depends on the positions: each thread reuses the
+        // symbolic analysis of its solver for all of its frames
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            SurfaceMesh frame_mesh = mesh;
+            ConstrainedSolver cholesky(n, is_constrained);
+            SparseMatrix L;
+            DiagonalMatrix M;
+            DenseMatrix X, B;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for (int f = 0; f < n_frames; ++f)
+            {
+                try
+                {
+                    frame_mesh.positions() = frames[f];
+                    Scalar area_before(0);
+                    Point center_before(0, 0, 0);
+                    if (rescale)
+                    {
+                        area_before = surface_area(frame_mesh);
+                        center_before = centroid(frame_mesh);
+                    }
+
+                    laplace_matrix(frame_mesh, L);
+                    for (unsigned int iter = 0; iter < iterations; ++iter)
+                    {
+                        mass_matrix(frame_mesh, M);
+                        coordinates_to_matrix(frame_mesh, X);
+                        B = M * X;
+                        X = cholesky.solve(SparseMatrix(M) - timestep * L, B,
+                                           X);
+                        matrix_to_coordinates(X, frame_mesh);
+
+                        if (rescale)
+                            restore_area_and_center(frame_mesh, area_before,
+                                                    center_before);
+                    }
+
+                    frames[f] = frame_mesh.positions();
+                }
+                catch (...)
+                {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    if (!exception)
+                        exception = std::current_exception();
+                }
+            }
         }
     }
+
+    if (exception)
+        std::rethrow_exception(exception);
 }
 
 } // namespace pmp
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include "pmp/surface_mesh.h"
+#include "pmp/algorithms/numerics.h"
 
 namespace pmp {
 
@@ -13,10 +16,79 @@ namespace pmp {
 //! \param mesh The input mesh, modified in place.
 //! \param iterations The number of iterations performed.
 //! \param use_uniform_laplace Use uniform or cotan Laplacian. Default: cotan.
+//! \sa ExplicitSmoother
 //! \ingroup algorithms
 void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations = 10,
                         bool use_uniform_laplace = false);
 
+//! \brief Explicit smoothing engine for many cheap iterations.
+//! \details Stores the normalized Laplacian weights in compressed sparse row
+//! format and the vertex positions as separate x, y, and z arrays in single
+//! precision. Each iteration is a Jacobi update reading one position buffer
+//! and writing the other, in parallel if OpenMP is available. Boundary
+//! vertices and vertices without positive weights remain fixed.
+//! \note This algorithm works on general polygon meshes.
+//! \ingroup algorithms
+class ExplicitSmoother
+{
+public:
+    //! \brief Set up the Laplacian weights and read the positions of \p mesh.
+    //! \param mesh The input mesh.
+    //! \param use_uniform_laplace Use uniform or cotan Laplacian. Negative
+    //! cotan weights are clamped to zero.
+    explicit ExplicitSmoother(const SurfaceMesh& mesh,
+                              bool use_uniform_laplace = false);
+
+    //! \brief Read the vertex positions of \p mesh, e.g., of another frame.
+    //! \throw InvalidInputException if the number of vertices differs.
+    void read(const SurfaceMesh& mesh);
+
+    //! \brief Write the smoothed vertex positions to \p mesh.
+    //! \throw InvalidInputException if the number of vertices differs.
+    void write(SurfaceMesh& mesh) const;
+
+    //! \brief Laplacian smoothing, moving each vertex by the fraction
+    //! \p lambda towards the weighted average of its neighbors.
+    void smooth(unsigned int iterations, Scalar lambda = 0.5);
+
+    //! \brief Taubin smoothing, alternating steps with the positive factor
+    //! \p lambda and the negative factor \p mu to avoid shrinkage.
+    //! \details See \cite taubin_1995_signal for details.
+    void taubin_smooth(unsigned int iterations, Scalar lambda = 0.5,
+                       Scalar mu = -0.53);
+
+    //! \brief HC smoothing, pushing the vertices of each Laplacian step back
+    //! towards the previous and the original positions to avoid shrinkage.
+    //! \details See \cite vollmer_1999_improved for details. The original
+    //! positions are the ones set by the constructor or by read().
+    //! \param iterations The number of iterations.
+    //! \param alpha The influence of the original positions.
+    //! \param beta The influence of the previous positions.
+    void hc_smooth(unsigned int iterations, Scalar alpha = 0.0,
+                   Scalar beta = 0.5);
+
+private:
+    // out = a * in + c * (W(in) - in) + d * base, coordinate-wise, such
+    // that fixed vertices are not changed by round-off
+    void apply(const std::vector<Scalar>& in, std::vector<Scalar>& out,
+               Scalar a, Scalar c, Scalar d = 0,
+               const std::vector<Scalar>* base = nullptr) const;
+
+    unsigned int n_vertices_;
+
+    // normalized weights W, with a single unit weight on the diagonal for
+    // fixed vertices
+    std::vector<unsigned int> row_offsets_;
+    std::vector<unsigned int> columns_;
+    std::vector<Scalar> weights_;
+
+    // x, y, and z coordinates of all vertices, one after the other
+    std::vector<Scalar> positions_;
+    std::vector<Scalar> original_;
+    std::vector<Scalar> buffer_;
+    std::vector<Scalar> difference_;
+};
+
 //! \brief Perform implicit Laplacian smoothing.
 //! \details See \cite desbrun_1999_implicit and \cite kazhdan_2012 .
 //! \note This algorithm works on general polygon meshes.
@@ -25,10 +97,41 @@ void explicit_smoothing(SurfaceMesh& mesh, unsigned int iterations = 10,
 //! \param iterations The number of iterations performed.
 //! \param use_uniform_laplace Use uniform or cotan Laplacian. Default: cotan.
 //! \param rescale Re-center and re-scale model after smoothing. Default: true.
+//! \param solver The linear solver. The matrix-free conjugate gradient solver
+//! requires much less memory for large meshes, but requires a triangle mesh
+//! unless the uniform Laplacian is used. The multigrid solver scales to large
+//! meshes and requires a triangle mesh. The mixed precision solver halves the
+//! memory of the Cholesky factorization. Default: Cholesky.
 //! \throw SolverException in case of a failure to solve the linear system.
+//! \throw InvalidInputException if the conjugate gradient solver is used with
+//! the cotan Laplacian on a mesh that is not a triangle mesh, or if the
+//! multigrid solver is used on a mesh that is not a triangle mesh.
 //! \ingroup algorithms
 void implicit_smoothing(SurfaceMesh& mesh, Scalar timestep = 0.001,
                         unsigned int iterations = 1,
+                        bool use_uniform_laplace = false, bool rescale = true,
+                        LinearSolver solver = LinearSolver::Cholesky);
+
+//! \brief Perform implicit Laplacian smoothing of several frames of a mesh.
+//! \details All frames share the connectivity of \p mesh, e.g., the frames of
+//! an animation. With the uniform Laplacian the system matrix only depends on
+//! the connectivity and is factorized once for all frames. Otherwise, the
+//! symbolic analysis of the Cholesky factorization is reused across frames.
+//! Frames are processed in parallel if OpenMP is available.
+//! \param mesh The mesh providing the connectivity. Its positions are ignored.
+//! \param frames The vertex positions of each frame, indexed by vertex index,
+//! modified in place.
+//! \param timestep The time step taken.
+//! \param iterations The number of iterations performed.
+//! \param use_uniform_laplace Use uniform or cotan Laplacian. Default: cotan.
+//! \param rescale Re-center and re-scale each frame after smoothing.
+//! \throw InvalidInputException if the mesh has deleted vertices or the size
+//! of a frame differs from the number of vertices.
+//! \throw SolverException in case of a failure to solve the linear system.
+//! \ingroup algorithms
+void implicit_smoothing(const SurfaceMesh& mesh,
+                        std::vector<std::vector<Point>>& frames,
+                        Scalar timestep = 0.001, unsigned int iterations = 1,
                         bool use_uniform_laplace = false, bool rescale = true);
 
 } // namespace pmp
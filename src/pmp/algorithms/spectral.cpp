@@ -0,0 +1,314 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "pmp/algorithms/spectral.h"
+#include "pmp/algorithms/laplace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+
+namespace pmp {
+namespace {
+
+// number of Lanczos vectors added per iteration, larger than the typical
+// multiplicity of eigenvalues of symmetric meshes
+constexpr Eigen::Index block_size = 8;
+
+// relative norm below which a Lanczos vector is considered linearly
+// dependent on the previous ones
+constexpr double breakdown_tolerance = 1e-10;
+
+// fill X with random values in [-1, 1]
+void randomize(Eigen::Ref<DenseMatrix> X, std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    for (Eigen::Index j = 0; j < X.cols(); ++j)
+        for (Eigen::Index i = 0; i < X.rows(); ++i)
+            X(i, j) = uniform(generator);
+}
+
+// Orthogonalize the columns of X against the first n columns of V with
+// respect to the mass inner product, using two passes of classical
+// Gram-Schmidt. Adds the coefficients of X in terms of V to C.
+void orthogonalize(const Eigen::Ref<const DenseMatrix>& V, Eigen::Index n,
+                   const Eigen::VectorXd& mass, Eigen::Ref<DenseMatrix> X,
+                   Eigen::Ref<DenseMatrix> C)
+{
+    if (n == 0)
+        return;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        const DenseMatrix D =
+            V.leftCols(n).transpose() * (mass.asDiagonal() * X);
+        X.noalias() -= V.leftCols(n) * D;
+        C += D;
+    }
+}
+
+// Orthonormalize the block W against the first `begin` columns of V and
+// store the result in the columns starting at `begin`, such that
+// W = V.leftCols(begin) * H + V.middleCols(begin, b) * R with upper
+// triangular R. Columns of W depending linearly on the previous ones are
+// replaced by random vectors and have zero diagonal entries in R.
+void orthonormalize(DenseMatrix& V, Eigen::Index begin, DenseMatrix& W,
+                    const Eigen::VectorXd& mass, std::mt19937& generator,
+                    DenseMatrix& H, DenseMatrix& R)
+{
+    const Eigen::Index b = W.cols();
+    const Eigen::VectorXd norms =
+        (W.array().square().colwise() * mass.array()).colwise().sum().sqrt();
+
+    H = DenseMatrix::Zero(begin, b);
+    orthogonalize(V, begin, mass, W, H);
+
+    R = DenseMatrix::Zero(b, b);
+    Eigen::VectorXd r;
+    for (Eigen::Index c = 0; c < b; ++c)
+    {
+        auto w = W.col(c);
+        r = Eigen::VectorXd::Zero(c);
+        orthogonalize(V.middleCols(begin, c), c, mass, w, r);
+        R.col(c).head(c) = r;
+
+        double norm = std::sqrt(w.dot(mass.cwiseProduct(w)));
+        if (norm > breakdown_tolerance * norms[c])
+        {
+            R(c, c) = norm;
+        }
+        else
+        {
+            randomize(w, generator);
+            r = Eigen::VectorXd::Zero(begin + c);
+            orthogonalize(V, begin + c, mass, w, r);
+            norm = std::sqrt(w.dot(mass.cwiseProduct(w)));
+        }
+        V.col(begin + c) = w / norm;
+    }
+}
+
+// check that the basis is defined on the vertices of mesh
+void check_basis(const SurfaceMesh& mesh, const LaplaceEigenbasis& basis,
+                 const std::string& func)
+{
+    if (mesh.n_vertices() != mesh.vertices_size() ||
+        basis.eigenvectors.rows() != Eigen::Index(mesh.n_vertices()))
+    {
+        auto what =
+            func + ": Eigenbasis does not match the vertices of the mesh.";
+        throw InvalidInputException(what);
+    }
+}
+
+} // namespace
+
+LaplaceEigenbasis laplace_eigenbasis(const SurfaceMesh& mesh, unsigned int k,
+                                     double tolerance,
+                                     unsigned int max_restarts)
+{
+    const Eigen::Index n = mesh.n_vertices();
+    if (mesh.n_vertices() != mesh.vertices_size())
+    {
+        auto what = std::string{__func__} + ": Mesh has deleted vertices.";
+        throw InvalidInputException(what);
+    }
+    if (k == 0 || k > n)
+    {
+        auto what = std::string{__func__} + ": Invalid number of eigenpairs.";
+        throw InvalidInputException(what);
+    }
+
+    LaplaceEigenbasis basis;
+    SparseMatrix L;
+    laplace_matrix(mesh, L);
+    mass_matrix(mesh, basis.mass);
+    const Eigen::VectorXd& mass = basis.mass.diagonal();
+    const SparseMatrix K = -L;
+
+    if (mass.minCoeff() <= 0.0)
+    {
+        auto what = std::string{__func__} +
+                    ": Singular mass matrix, e.g., due to isolated vertices.";
+        throw SolverException(what);
+    }
+
+    // dimension of the Krylov subspace and number of Ritz vectors kept at
+    // restarts, both multiples of the block size
+    auto round_up = [](Eigen::Index i) {
+        return (i + block_size - 1) / block_size * block_size;
+    };
+    const Eigen::Index m = round_up(k + std::max(k / 2, 32u));
+    const Eigen::Index p = (k + (m - k) / 2) / block_size * block_size;
+
+    // small problems: dense eigendecomposition of M^-1/2 K M^-1/2
+    if (m + block_size > n)
+    {
+        const Eigen::VectorXd s = mass.cwiseSqrt().cwiseInverse();
+        const DenseMatrix A = s.asDiagonal() * DenseMatrix(K) * s.asDiagonal();
+        const Eigen::SelfAdjointEigenSolver<DenseMatrix> eigensolver(A);
+        if (eigensolver.info() != Eigen::Success)
+        {
+            auto what =
+                std::string{__func__} + ": Eigendecomposition failed.";
+            throw SolverException(what);
+        }
+        basis.eigenvalues = eigensolver.eigenvalues().head(k);
+        basis.eigenvectors =
+            s.asDiagonal() * eigensolver.eigenvectors().leftCols(k);
+        return basis;
+    }
+
+    // the shift below the smallest eigenvalue zero is small compared to the
+    // spectrum, such that the smallest eigenvalues are well separated
+    const double sigma = -1e-6 * K.diagonal().sum() / mass.sum();
+    SparseSolverCache solver;
+    solver.factorize(K - sigma * SparseMatrix(basis.mass));
+
+    // Lanczos vectors, including the residual block
+    DenseMatrix V(n, m + block_size);
+    DenseMatrix T = DenseMatrix::Zero(m, m);
+    DenseMatrix W(n, block_size), H, R;
+    std::mt19937 generator(42);
+
+    randomize(W, generator);
+    orthonormalize(V, 0, W, mass, generator, H, R);
+
+    Eigen::SelfAdjointEigenSolver<DenseMatrix> ritz;
+    Eigen::Index start = 0;
+    for (unsigned int restart = 0;; ++restart)
+    {
+        // extend the basis by the shift-inverted operator applied to the last
+        // block, T = V^T M (K - sigma M)^-1 M V is its projection
+        for (Eigen::Index s = start; s < m; s += block_size)
+        {
+            W = solver.solve(mass.asDiagonal() * V.middleCols(s, block_size));
+            orthonormalize(V, s + block_size, W, mass, generator, H, R);
+            T.block(0, s, s + block_size, block_size) = H;
+            T.block(s, 0, block_size, s + block_size) = H.transpose();
+        }
+
+        // the largest Ritz values belong to the smallest eigenvalues
+        ritz.compute(T);
+        if (ritz.info() != Eigen::Success)
+        {
+            auto what =
+                std::string{__func__} + ": Rayleigh-Ritz projection failed.";
+            throw SolverException(what);
+        }
+        const Eigen::VectorXd& theta = ritz.eigenvalues();
+        const DenseMatrix& Y = ritz.eigenvectors();
+
+        bool converged = true;
+        for (Eigen::Index i = m - k; i < m && converged; ++i)
+        {
+            const double residual = (R * Y.col(i).tail(block_size)).norm();
+            converged = residual <= tolerance * std::abs(theta[i]);
+        }
+        if (converged)
+        {
+            basis.eigenvectors =
+                V.leftCols(m) * Y.rightCols(k).rowwise().reverse();
+            break;
+        }
+
+        if (restart == max_restarts)
+        {
+            auto what = std::string{__func__} +
+                        ": Lanczos iteration did not converge.";
+            throw SolverException(what);
+        }
+
+        // thick restart with the p largest Ritz pairs and the residual block
+        const DenseMatrix ritz_vectors =
+            V.leftCols(m) * Y.rightCols(p).rowwise().reverse();
+        V.leftCols(p) = ritz_vectors;
+        V.middleCols(p, block_size) = V.middleCols(m, block_size);
+        T.setZero();
+        T.diagonal().head(p) = theta.tail(p).reverse();
+        start = p;
+    }
+
+    // Rayleigh quotients are more accurate than the shifted Ritz values
+    const DenseMatrix KPhi = K * basis.eigenvectors;
+    basis.eigenvalues =
+        basis.eigenvectors.cwiseProduct(KPhi).colwise().sum().transpose();
+
+    return basis;
+}
+
+const LaplaceEigenbasis& LaplaceEigenbasisCache::basis(const SurfaceMesh& mesh,
+                                                       unsigned int k)
+{
+    std::vector<unsigned int> connectivity;
+    connectivity.reserve(mesh.n_faces() * 4 + 1);
+    connectivity.push_back(mesh.n_vertices());
+    for (auto f : mesh.faces())
+    {
+        connectivity.push_back(mesh.valence(f));
+        for (auto v : mesh.vertices(f))
+            connectivity.push_back(v.idx());
+    }
+
+    if (connectivity != connectivity_ ||
+        basis_.eigenvalues.size() != Eigen::Index(k))
+    {
+        // invalidate first in case of exceptions
+        connectivity_.clear();
+        basis_ = laplace_eigenbasis(mesh, k);
+        connectivity_ = std::move(connectivity);
+        ++n_computations_;
+    }
+
+    return basis_;
+}
+
+void spectral_smoothing(SurfaceMesh& mesh, const LaplaceEigenbasis& basis,
+                        const std::function<double(double)>& filter)
+{
+    check_basis(mesh, basis, __func__);
+
+    Eigen::VectorXd scaling(basis.eigenvalues.size());
+    for (Eigen::Index i = 0; i < scaling.size(); ++i)
+        scaling[i] = filter(basis.eigenvalues[i]);
+
+    DenseMatrix X;
+    coordinates_to_matrix(mesh, X);
+    const DenseMatrix C = scaling.asDiagonal() *
+                          (basis.eigenvectors.transpose() * (basis.mass * X));
+    X.noalias() = basis.eigenvectors * C;
+    matrix_to_coordinates(X, mesh);
+}
+
+DenseMatrix spectral_compress(const SurfaceMesh& mesh,
+                              const LaplaceEigenbasis& basis, unsigned int k)
+{
+    check_basis(mesh, basis, __func__);
+    if (Eigen::Index(k) > basis.eigenvectors.cols())
+    {
+        auto what = std::string{__func__} + ": Too many coefficients.";
+        throw InvalidInputException(what);
+    }
+
+    DenseMatrix X;
+    coordinates_to_matrix(mesh, X);
+    return basis.eigenvectors.leftCols(k).transpose() * (basis.mass * X);
+}
+
+void spectral_decompress(SurfaceMesh& mesh, const LaplaceEigenbasis& basis,
+                         const DenseMatrix& coefficients)
+{
+    check_basis(mesh, basis, __func__);
+    if (coefficients.rows() > basis.eigenvectors.cols() ||
+        coefficients.cols() != 3)
+    {
+        auto what = std::string{__func__} + ": Invalid coefficients.";
+        throw InvalidInputException(what);
+    }
+
+    const DenseMatrix X =
+        basis.eigenvectors.leftCols(coefficients.rows()) * coefficients;
+    matrix_to_coordinates(X, mesh);
+}
+
+} // namespace pmp
@@ -0,0 +1,119 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "pmp/surface_mesh.h"
+#include "pmp/algorithms/numerics.h"
+
+namespace pmp {
+
+//! \brief Eigenbasis of the Laplace-Beltrami operator of a mesh.
+//! \details Eigenpairs of the generalized eigenvalue problem
+//! \f$-L \phi = \lambda M \phi\f$ for the Laplace matrix \f$L\f$ and the mass
+//! matrix \f$M\f$ of the mesh. The eigenvectors are orthonormal with respect
+//! to \f$M\f$, i.e., \f$\Phi^T M \Phi = I\f$.
+//! \sa laplace_eigenbasis()
+struct LaplaceEigenbasis
+{
+    //! The eigenvalues in increasing order.
+    Eigen::VectorXd eigenvalues;
+
+    //! The eigenvectors, one per column, indexed by vertex index.
+    DenseMatrix eigenvectors;
+
+    //! The mass matrix used as inner product.
+    DiagonalMatrix mass;
+};
+
+//! \brief Compute the eigenpairs of the Laplace-Beltrami operator with the
+//! smallest eigenvalues.
+//! \details Uses thick-restart Lanczos iterations for the shift-inverted
+//! operator \f$(-L - \sigma M)^{-1} M\f$ with a small negative shift
+//! \f$\sigma\f$, such that the smallest eigenvalues converge first. The
+//! shifted matrix is factorized once and reused for all iterations. The
+//! Lanczos vectors are fully reorthogonalized, in parallel if OpenMP is
+//! available.
+//! \param mesh The input mesh.
+//! \param k The number of eigenpairs.
+//! \param tolerance The relative residual tolerance of the eigenpairs of the
+//! shift-inverted operator.
+//! \param max_restarts The maximum number of restarts of the iteration.
+//! \return The k eigenpairs with the smallest eigenvalues.
+//! \throw InvalidInputException if k is zero or larger than the number of
+//! vertices, or if the mesh has deleted vertices.
+//! \throw SolverException in case of failure to factorize the shifted matrix,
+//! e.g., for meshes with isolated vertices, or if the iteration does not
+//! converge.
+//! \note This algorithm works on general polygon meshes.
+//! \ingroup algorithms
+LaplaceEigenbasis laplace_eigenbasis(const SurfaceMesh& mesh, unsigned int k,
+                                     double tolerance = 1e-8,
+                                     unsigned int max_restarts = 100);
+
+//! \brief Cache for the Laplace eigenbasis of meshes sharing their
+//! connectivity.
+//! \details The eigenbasis is only recomputed if the connectivity of the mesh
+//! or the number of eigenpairs differ from the previous request, such that
+//! many frames of an animated mesh are processed in the eigenbasis of the
+//! first frame.
+//! \ingroup algorithms
+class LaplaceEigenbasisCache
+{
+public:
+    //! \brief Get the eigenbasis with \p k eigenpairs for \p mesh.
+    //! \details The reference is valid until the next call.
+    //! \throw InvalidInputException, SolverException as laplace_eigenbasis().
+    const LaplaceEigenbasis& basis(const SurfaceMesh& mesh, unsigned int k);
+
+    //! Returns the number of eigenbasis computations performed so far.
+    unsigned int n_computations() const { return n_computations_; }
+
+private:
+    // vertex indices of all faces, each preceded by its valence
+    std::vector<unsigned int> connectivity_;
+    LaplaceEigenbasis basis_;
+    unsigned int n_computations_{0};
+};
+
+//! \brief Spectral smoothing of the vertex positions.
+//! \details Projects the positions onto the eigenbasis, scales each
+//! coefficient by the filter value of its eigenvalue, and reconstructs the
+//! positions from the filtered coefficients. Frequencies not contained in
+//! the basis are removed, i.e., a constant filter of one yields the low-pass
+//! filtered mesh. Costs O(nk) for n vertices and k eigenpairs.
+//! \param mesh The input mesh, modified in place.
+//! \param basis The eigenbasis, e.g., of a previous frame of the mesh.
+//! \param filter A function returning the scaling factor of an eigenvalue.
+//! \throw InvalidInputException if the size of the basis does not match the
+//! number of vertices.
+//! \sa laplace_eigenbasis(), LaplaceEigenbasisCache
+//! \ingroup algorithms
+void spectral_smoothing(SurfaceMesh& mesh, const LaplaceEigenbasis& basis,
+                        const std::function<double(double)>& filter);
+
+//! \brief Spectral geometry compression.
+//! \details Computes the coefficients of the vertex positions with respect
+//! to the first \p k eigenvectors, i.e., those of the lowest frequencies.
+//! \return A kx3 matrix of coefficients.
+//! \throw InvalidInputException if the size of the basis does not match the
+//! number of vertices or if k exceeds the number of eigenvectors.
+//! \sa spectral_decompress()
+//! \ingroup algorithms
+DenseMatrix spectral_compress(const SurfaceMesh& mesh,
+                              const LaplaceEigenbasis& basis, unsigned int k);
+
+//! \brief Reconstruct the vertex positions from spectral coefficients.
+//! \param mesh The mesh, its vertex positions are replaced.
+//! \param basis The eigenbasis used for compression.
+//! \param coefficients The coefficients computed by spectral_compress().
+//! \throw InvalidInputException if the size of the basis does not match the
+//! number of vertices or if there are more coefficients than eigenvectors.
+//! \ingroup algorithms
+void spectral_decompress(SurfaceMesh& mesh, const LaplaceEigenbasis& basis,
+                         const DenseMatrix& coefficients);
+
+} // namespace pmp
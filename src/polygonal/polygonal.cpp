@@ -1417,7 +1417,7 @@ Vertex Polygonal::pick_vertex(int x, int y)
     // re-build tree if necessary
     if (tree_ == nullptr)
     {
-        tree_ = std::make_unique<AABBTree>(mesh_);
+        tree_ = std::make_unique<BVH>(mesh_);
     }
 
     Vertex result;
@@ -1486,9 +1486,9 @@ void Polygonal::select_lasso(bool surface)
     vec4 cam_pos4 = imv * vec4(0.0f, 0.0f, 0.0f, 1.0f);
     vec3 cam_pos(cam_pos4[0], cam_pos4[1], cam_pos4[2]);
 
-    // build AABB tree if needed
+    // build BVH if needed
     if (surface && !tree_)
-        tree_ = std::make_unique<AABBTree>(mesh_);
+        tree_ = std::make_unique<BVH>(mesh_);
 
     // project vertices to screen and test if inside lasso
     auto selected = mesh_.vertex_property<bool>("v:selected");
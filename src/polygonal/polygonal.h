@@ -5,7 +5,7 @@
 
 #include <pmp/viewers/trackball_viewer.h>
 #include <pmp/viewers/renderer.h>
-#include "aabb_tree.h"
+#include <pmp/algorithms/bvh.h>
 #include "lasso_drawable.h"
 
 #include <memory>
@@ -86,7 +86,7 @@ private:
 
     // picking
     Vertex pick_vertex(int x, int y);
-    std::unique_ptr<AABBTree> tree_;
+    std::unique_ptr<BVH> tree_;
 
     // lasso selection
     void select_lasso(bool surface = true);
@@ -0,0 +1,128 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/bvh.h"
+#include "pmp/algorithms/distance_point_triangle.h"
+#include "pmp/algorithms/shapes.h"
+#include "pmp/exceptions.h"
+
+#include <random>
+
+using namespace pmp;
+
+TEST(BVHTest, nearest)
+{
+    auto mesh = icosphere(3);
+    BVH bvh(mesh);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> uniform(-2, 2);
+    for (int i = 0; i < 100; ++i)
+    {
+        const Point p(uniform(rng), uniform(rng), uniform(rng));
+
+        // brute force
+        Scalar min_dist = std::numeric_limits<Scalar>::max();
+        for (auto f : mesh.faces())
+        {
+            auto fv = mesh.vertices(f);
+            const Point p0 = mesh.position(*fv);
+            const Point p1 = mesh.position(*++fv);
+            const Point p2 = mesh.position(*++fv);
+            Point nearest;
+            min_dist = std::min(min_dist,
+                                dist_point_triangle(p, p0, p1, p2, nearest));
+        }
+
+        const auto nn = bvh.nearest(p);
+        EXPECT_NEAR(nn.dist, min_dist, 1e-5);
+        EXPECT_NEAR(distance(nn.nearest, p), nn.dist, 1e-5);
+        EXPECT_TRUE(nn.face.is_valid());
+    }
+}
+
+TEST(BVHTest, closest_points)
+{
+    auto mesh = icosphere(3);
+    BVH bvh(mesh);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> uniform(-2, 2);
+    std::vector<Point> queries(1000);
+    for (auto& q : queries)
+        q = Point(uniform(rng), uniform(rng), uniform(rng));
+
+    std::vector<Face> faces(queries.size());
+    std::vector<Point> points(queries.size());
+    std::vector<Scalar> distances(queries.size());
+    bvh.closest_points(queries, faces, points, distances);
+
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        const auto nn = bvh.nearest(queries[i]);
+        EXPECT_NEAR(distances[i], nn.dist, 1e-5);
+        EXPECT_NEAR(distance(points[i], queries[i]), distances[i], 1e-5);
+        EXPECT_TRUE(faces[i].is_valid());
+    }
+
+    distances.pop_back();
+    EXPECT_THROW(bvh.closest_points(queries, faces, points, distances),
+                 InvalidInputException);
+}
+
+TEST(BVHTest, intersect)
+{
+    auto mesh = hexahedron();
+    BVH bvh(mesh);
+
+    // ray from outside through the center hits the cube at distance
+    // 2 - 1/sqrt(3)
+    const Point origin(0, 0, 2);
+    auto hit = bvh.intersect(origin, Point(0, 0, -1));
+    ASSERT_TRUE(hit);
+    EXPECT_NEAR(hit->t, 2 - 1 / std::sqrt(3.0), 1e-5);
+
+    // the hit face is the one with normal (0,0,1)
+    for (auto v : mesh.vertices(hit->face))
+        EXPECT_NEAR(mesh.position(v)[2], 1 / std::sqrt(3.0), 1e-5);
+
+    // limiting the ray parameter gives the back face or no hit at all
+    hit = bvh.intersect(origin, Point(0, 0, -1), 2);
+    ASSERT_TRUE(hit);
+    EXPECT_NEAR(hit->t, 2 + 1 / std::sqrt(3.0), 1e-5);
+    EXPECT_FALSE(bvh.intersect(origin, Point(0, 0, -1), 0, 1));
+    EXPECT_FALSE(bvh.intersect(origin, Point(0, 0, 1)));
+}
+
+TEST(BVHTest, overlapping_faces)
+{
+    auto mesh = icosphere(2);
+    BVH bvh(mesh);
+
+    const BoundingBox box(Point(0, 0, 0), Point(1, 1, 1));
+    auto faces = bvh.overlapping_faces(box);
+
+    // brute force
+    std::vector<Face> expected;
+    for (auto f : mesh.faces())
+    {
+        BoundingBox bb;
+        for (auto v : mesh.vertices(f))
+            bb += mesh.position(v);
+        if (bb.max()[0] >= 0 && bb.max()[1] >= 0 && bb.max()[2] >= 0)
+            expected.push_back(f);
+    }
+    EXPECT_EQ(faces, expected);
+}
+
+TEST(BVHTest, empty_mesh)
+{
+    SurfaceMesh mesh;
+    BVH bvh(mesh);
+    EXPECT_FALSE(bvh.nearest(Point(0, 0, 0)).face.is_valid());
+    EXPECT_FALSE(bvh.intersect(Point(0, 0, 0), Point(1, 0, 0)));
+    EXPECT_TRUE(
+        bvh.overlapping_faces(BoundingBox(Point(-1), Point(1))).empty());
+}
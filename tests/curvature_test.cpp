@@ -5,6 +5,8 @@
 
 #include "pmp/algorithms/curvature.h"
 #include "pmp/algorithms/shapes.h"
+#include "pmp/algorithms/subdivision.h"
+#include "helpers.h"
 
 using namespace pmp;
 
@@ -63,3 +65,114 @@ TEST_F(CurvatureTest, curvature_to_texture_coordinates)
     auto tex = mesh.vertex_property<TexCoord>("v:tex");
     EXPECT_TRUE(tex);
 }
+
+TEST_F(CurvatureTest, update_curvature)
+{
+    auto cone = open_cone();
+    loop_subdivision(cone);
+    loop_subdivision(cone);
+    auto curvatures = cone.vertex_property<Scalar>("v:curv");
+
+    // some interior vertices, a boundary vertex, and one of its neighbors
+    std::vector<Vertex> changed{Vertex(0), Vertex(7), Vertex(42)};
+    for (auto v : cone.vertices())
+        if (cone.is_boundary(v))
+        {
+            changed.push_back(v);
+            changed.push_back(*cone.vertices(v).begin());
+            break;
+        }
+
+    for (bool use_tensor : {false, true})
+    {
+        for (bool use_two_ring : {false, true})
+        {
+            curvature(cone, Curvature::Mean, 0, use_tensor, use_two_ring);
+
+            for (auto v : changed)
+                cone.position(v) += Point(0.05, -0.1, 0.1);
+            update_curvature(cone, changed, Curvature::Mean, use_tensor,
+                             use_two_ring);
+            const auto updated = curvatures.vector();
+
+            curvature(cone, Curvature::Mean, 0, use_tensor, use_two_ring);
+            for (auto v : cone.vertices())
+                EXPECT_NEAR(updated[v.idx()], curvatures[v],
+                            1e-4 * (1.0 + std::abs(curvatures[v])));
+        }
+    }
+}
+
+TEST_F(CurvatureTest, update_curvature_without_curvature)
+{
+    EXPECT_THROW(update_curvature(mesh, {Vertex(0)}), InvalidInputException);
+}
+
+TEST_F(CurvatureTest, update_curvature_after_topology_changes)
+{
+    auto cone = open_cone();
+    loop_subdivision(cone);
+    loop_subdivision(cone);
+    auto curvatures = cone.vertex_property<Scalar>("v:curv");
+
+    // a vertex and the vertices of its incident faces
+    auto around = [&](Vertex v, std::vector<Vertex>& changed) {
+        changed.push_back(v);
+        for (auto vv : cone.vertices(v))
+            changed.push_back(vv);
+    };
+
+    for (bool use_tensor : {false, true})
+    {
+        for (bool use_two_ring : {false, true})
+        {
+            curvature(cone, Curvature::Mean, 0, use_tensor, use_two_ring);
+            std::vector<Vertex> changed;
+
+            // flip an interior edge, split an interior and a boundary edge
+            Edge flipped, interior, boundary;
+            for (auto e : cone.edges())
+            {
+                if (!flipped.is_valid() && cone.is_flip_ok(e))
+                    flipped = e;
+                else if (!boundary.is_valid() && cone.is_boundary(e))
+                    boundary = e;
+                else if (!interior.is_valid() && !cone.is_boundary(e))
+                    interior = e;
+            }
+            cone.flip(flipped);
+            around(cone.vertex(flipped, 0), changed);
+            around(cone.vertex(flipped, 1), changed);
+            for (auto e : {interior, boundary})
+            {
+                const Point p = 0.5 * (cone.position(cone.vertex(e, 0)) +
+                                       cone.position(cone.vertex(e, 1))) +
+                                Point(0.0, 0.05, 0.0);
+                around(cone.to_vertex(cone.split(e, p)), changed);
+            }
+
+            // collapse an edge, passing the removed vertex as well
+            for (auto h : cone.halfedges())
+            {
+                if (!cone.is_boundary(cone.edge(h)) && cone.is_collapse_ok(h))
+                {
+                    changed.push_back(cone.from_vertex(h));
+                    const Vertex v = cone.to_vertex(h);
+                    cone.collapse(h);
+                    around(v, changed);
+                    break;
+                }
+            }
+
+            update_curvature(cone, changed, Curvature::Mean, use_tensor,
+                             use_two_ring);
+            cone.garbage_collection();
+            const auto updated = curvatures.vector();
+
+            curvature(cone, Curvature::Mean, 0, use_tensor, use_two_ring);
+            for (auto v : cone.vertices())
+                EXPECT_NEAR(updated[v.idx()], curvatures[v],
+                            1e-4 * (1.0 + std::abs(curvatures[v])));
+        }
+    }
+}
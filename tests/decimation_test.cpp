@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 
 #include "pmp/algorithms/decimation.h"
+#include "pmp/algorithms/distance_point_triangle.h"
 #include "pmp/algorithms/features.h"
 #include "pmp/algorithms/shapes.h"
 #include "pmp/algorithms/subdivision.h"
@@ -84,3 +85,33 @@ TEST(DecimationTest, simplification_texture_mesh)
     EXPECT_EQ(seams[se], 1);
     EXPECT_EQ(seams[se2], 1);
 }
+
+// simplify while bounding the deviation from the original surface
+TEST(DecimationTest, simplification_hausdorff)
+{
+    auto mesh = icosphere(3);
+    const auto original = mesh;
+    const Scalar error = 0.05;
+    decimate(mesh, 10, 0, 0, 0, 0, error);
+
+    // the error bound prevents full simplification
+    EXPECT_GT(mesh.n_vertices(), size_t(10));
+    EXPECT_LT(mesh.n_vertices(), original.n_vertices());
+
+    // original vertices stay close to the simplified surface
+    for (auto v : original.vertices())
+    {
+        Scalar dmin = std::numeric_limits<Scalar>::max();
+        for (auto f : mesh.faces())
+        {
+            auto fv = mesh.vertices(f);
+            const auto& p0 = mesh.position(*fv);
+            const auto& p1 = mesh.position(*(++fv));
+            const auto& p2 = mesh.position(*(++fv));
+            Point nearest;
+            dmin = std::min(dmin, dist_point_triangle(original.position(v), p0,
+                                                      p1, p2, nearest));
+        }
+        EXPECT_LT(dmin, error);
+    }
+}
@@ -6,6 +6,7 @@
 #include "pmp/algorithms/fairing.h"
 #include "pmp/algorithms/subdivision.h"
 #include "pmp/algorithms/utilities.h"
+#include "pmp/exceptions.h"
 #include "helpers.h"
 
 using namespace pmp;
@@ -37,3 +38,48 @@ TEST(FairingTest, fairing_selected)
     auto bb2 = bounds(mesh);
     EXPECT_LT(bb2.size(), bb.size());
 }
+
+TEST(FairingTest, fairing_with_conjugate_gradients)
+{
+    for (unsigned int k : {1, 2})
+    {
+        auto mesh = open_cone();
+        loop_subdivision(mesh);
+        auto reference = mesh;
+        fair(reference, k);
+        fair(mesh, k, LinearSolver::ConjugateGradient);
+        for (auto v : mesh.vertices())
+            EXPECT_LT(distance(mesh.position(v), reference.position(v)), 1e-4);
+    }
+}
+
+TEST(FairingTest, fairing_frames)
+{
+    auto mesh = open_cone();
+    loop_subdivision(mesh);
+
+    // scaled and translated copies of the mesh
+    std::vector<std::vector<Point>> frames;
+    std::vector<SurfaceMesh> references;
+    for (int i = 0; i < 5; ++i)
+    {
+        auto frame = mesh;
+        for (auto v : frame.vertices())
+            frame.position(v) = (1.0f + 0.1f * i) * frame.position(v) +
+                                Point(i, 0, 0);
+        frames.push_back(frame.positions());
+        fair(frame);
+        references.push_back(frame);
+    }
+
+    fair(mesh, frames);
+    for (size_t i = 0; i < frames.size(); ++i)
+        for (auto v : mesh.vertices())
+            EXPECT_LT(distance(frames[i][v.idx()],
+                               references[i].position(v)),
+                      1e-5);
+
+    // wrong frame size
+    frames[0].pop_back();
+    EXPECT_THROW(fair(mesh, frames), InvalidInputException);
+}
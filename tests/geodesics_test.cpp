@@ -7,6 +7,8 @@
 #include <pmp/algorithms/shapes.h>
 #include <pmp/io/io.h>
 
+#include <algorithm>
+
 using namespace pmp;
 
 TEST(GeodesicsTest, geodesic)
@@ -87,3 +89,154 @@ TEST(GeodesicsTest, geodesic_maxnum)
         EXPECT_TRUE(distance[neighbors[i]] <= distance[neighbors[i + 1]]);
     }
 }
+
+TEST(GeodesicsTest, geodesic_solver)
+{
+    SurfaceMesh mesh;
+    read(mesh, "data/off/bunny_adaptive.off");
+    GeodesicSolver solver(mesh);
+
+    // repeated queries give the same result as geodesics()
+    for (auto seed : {Vertex(0), Vertex(100), Vertex(0)})
+    {
+        solver.compute(std::vector<Vertex>{seed});
+        geodesics(mesh, std::vector<Vertex>{seed});
+        auto distance = mesh.get_vertex_property<Scalar>("geodesic:distance");
+        for (auto v : mesh.vertices())
+            EXPECT_EQ(solver.distance(v), distance[v]);
+    }
+
+    // local queries only touch a small neighborhood
+    std::vector<Vertex> neighbors;
+    auto num = solver.compute(std::vector<Vertex>{Vertex(42)},
+                              std::numeric_limits<Scalar>::max(), 10,
+                              &neighbors);
+    EXPECT_EQ(num, 10u);
+    EXPECT_LT(solver.touched_vertices().size(), 50u);
+    for (auto v : mesh.vertices())
+    {
+        if (std::ranges::find(solver.touched_vertices(), v) ==
+            solver.touched_vertices().end())
+        {
+            EXPECT_EQ(solver.distance(v), std::numeric_limits<Scalar>::max());
+        }
+    }
+}
+
+TEST(GeodesicsTest, geodesics_heat_with_conjugate_gradients)
+{
+    SurfaceMesh mesh = icosphere(3);
+    const std::vector<Vertex> seeds{Vertex(0)};
+    geodesics_heat(mesh, seeds);
+    auto distance = mesh.get_vertex_property<Scalar>("geodesic:distance");
+    std::vector<Scalar> reference(distance.vector());
+
+    geodesics_heat(mesh, seeds, LinearSolver::ConjugateGradient);
+    for (auto v : mesh.vertices())
+        EXPECT_NEAR(distance[v], reference[v.idx()], 1e-4);
+}
+
+TEST(GeodesicsTest, heat_geodesics)
+{
+    SurfaceMesh mesh = icosphere(3);
+    HeatGeodesics heat(mesh);
+
+    // same result as geodesics_heat()
+    const std::vector<Vertex> seeds{Vertex(0)};
+    const Eigen::VectorXd dist = heat.compute(seeds);
+    geodesics_heat(mesh, seeds);
+    auto distance = mesh.get_vertex_property<Scalar>("geodesic:distance");
+    for (auto v : mesh.vertices())
+        EXPECT_NEAR(dist[v.idx()], distance[v], 1e-5);
+
+    // maximum distance on the unit sphere is about pi
+    EXPECT_NEAR(dist.maxCoeff(), 3.14, 0.1);
+
+    // solving several seed sets at once
+    const std::vector<std::vector<Vertex>> seed_sets{
+        {Vertex(0)}, {Vertex(10), Vertex(20)}, {Vertex(0)}};
+    const DenseMatrix dists = heat.compute(seed_sets);
+    ASSERT_EQ(dists.cols(), 3);
+    for (int j = 0; j < 3; ++j)
+        EXPECT_LT((dists.col(j) - heat.compute(seed_sets[j])).norm(), 1e-8);
+    EXPECT_LT((dists.col(0) - dist).norm(), 1e-8);
+}
+
+TEST(GeodesicsTest, geodesic_distance_matrix)
+{
+    SurfaceMesh mesh = icosphere(3);
+    const std::vector<Vertex> sources{Vertex(0), Vertex(5), Vertex(100)};
+    const std::vector<Vertex> targets{Vertex(1), Vertex(0), Vertex(200)};
+
+    const Eigen::MatrixXf dist =
+        geodesic_distance_matrix(mesh, sources, targets);
+    ASSERT_EQ(dist.rows(), 3);
+    ASSERT_EQ(dist.cols(), 3);
+    EXPECT_EQ(dist(0, 1), 0.0f);
+
+    auto distance = mesh.vertex_property<Scalar>("geodesic:distance");
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        geodesics(mesh, std::vector<Vertex>{sources[i]});
+        for (size_t j = 0; j < targets.size(); ++j)
+            EXPECT_EQ(dist(i, j), distance[targets[j]]);
+    }
+
+    // early termination
+    const Eigen::MatrixXf local =
+        geodesic_distance_matrix(mesh, sources, targets, 0.5);
+    for (Eigen::Index i = 0; i < dist.size(); ++i)
+    {
+        if (dist(i) <= 0.5)
+            EXPECT_EQ(local(i), dist(i));
+        else
+            EXPECT_EQ(local(i), std::numeric_limits<float>::max());
+    }
+}
+
+TEST(GeodesicsTest, farthest_point_sampling)
+{
+    SurfaceMesh mesh = icosphere(4);
+    auto samples = farthest_point_sampling(mesh, 50);
+    ASSERT_EQ(samples.size(), 50u);
+    EXPECT_EQ(samples[0], Vertex(0));
+
+    // second sample is the vertex farthest from the first one
+    geodesics(mesh, std::vector<Vertex>{samples[0]});
+    auto distance = mesh.get_vertex_property<Scalar>("geodesic:distance");
+    for (auto v : mesh.vertices())
+        EXPECT_LE(distance[v], distance[samples[1]]);
+
+    // samples are unique
+    std::ranges::sort(samples);
+    EXPECT_EQ(std::ranges::adjacent_find(samples), samples.end());
+}
+
+TEST(GeodesicsTest, poisson_disk_sampling)
+{
+    SurfaceMesh mesh = icosphere(4);
+    const Scalar radius = 0.5;
+    auto samples = poisson_disk_sampling(mesh, radius);
+    EXPECT_GT(samples.size(), 10u);
+
+    // samples are at least radius apart
+    const Eigen::MatrixXf dist =
+        geodesic_distance_matrix(mesh, samples, samples);
+    for (Eigen::Index i = 0; i < dist.rows(); ++i)
+    {
+        for (Eigen::Index j = 0; j < dist.cols(); ++j)
+        {
+            if (i != j)
+            {
+                EXPECT_GE(dist(i, j), radius);
+            }
+        }
+    }
+
+    // all vertices are closer than radius to a sample
+    std::vector<Vertex> vertices(mesh.vertices().begin(),
+                                 mesh.vertices().end());
+    const Eigen::MatrixXf coverage =
+        geodesic_distance_matrix(mesh, samples, vertices);
+    EXPECT_LT(coverage.colwise().minCoeff().maxCoeff(), 1.01 * radius);
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/heap.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace pmp;
+
+namespace {
+
+// heap interface operating on plain vectors of keys and positions
+class VectorHeapInterface
+{
+public:
+    VectorHeapInterface(std::vector<float>& keys, std::vector<int>& pos)
+        : keys_(&keys), pos_(&pos)
+    {
+    }
+
+    bool less(int i, int j) { return (*keys_)[i] < (*keys_)[j]; }
+    bool greater(int i, int j) { return (*keys_)[i] > (*keys_)[j]; }
+    int get_heap_position(int i) { return (*pos_)[i]; }
+    void set_heap_position(int i, int pos) { (*pos_)[i] = pos; }
+
+private:
+    std::vector<float>* keys_;
+    std::vector<int>* pos_;
+};
+
+template <unsigned int Arity>
+void test_heap()
+{
+    const int n = 1000;
+    std::vector<float> keys(n);
+    std::vector<int> pos(n, -1);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    Heap<int, VectorHeapInterface, Arity> heap(
+        VectorHeapInterface(keys, pos));
+    for (int i = 0; i < n; ++i)
+    {
+        keys[i] = uniform(rng);
+        heap.insert(i);
+    }
+    EXPECT_TRUE(heap.check());
+
+    // change some keys, remove some entries
+    for (int i = 0; i < n; i += 3)
+    {
+        keys[i] = uniform(rng);
+        heap.update(i);
+    }
+    for (int i = 0; i < n; i += 7)
+        heap.remove(i);
+    EXPECT_TRUE(heap.check());
+    EXPECT_FALSE(heap.is_stored(0));
+    EXPECT_TRUE(heap.is_stored(1));
+
+    // entries come out sorted
+    std::vector<float> sorted;
+    while (!heap.empty())
+    {
+        sorted.push_back(keys[heap.front()]);
+        heap.pop_front();
+    }
+    EXPECT_EQ(sorted.size(), size_t(n - (n + 6) / 7));
+    EXPECT_TRUE(std::ranges::is_sorted(sorted));
+    EXPECT_TRUE(std::ranges::all_of(pos, [](int p) { return p == -1; }));
+}
+
+} // namespace
+
+TEST(HeapTest, binary_heap)
+{
+    test_heap<2>();
+}
+
+TEST(HeapTest, four_ary_heap)
+{
+    test_heap<4>();
+}
+
+TEST(HeapTest, eight_ary_heap)
+{
+    test_heap<8>();
+}
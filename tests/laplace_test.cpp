@@ -6,10 +6,14 @@
 #include "pmp/algorithms/shapes.h"
 #include "pmp/algorithms/triangulation.h"
 #include "pmp/algorithms/differential_geometry.h"
+#include "pmp/exceptions.h"
+#include "helpers.h"
 
 // #include "pmp/algorithms/wild_laplace.h"
 #include <Eigen/Eigenvalues>
 #include <cstdlib>
+#include <numbers>
+#include <set>
 
 using namespace pmp;
 
@@ -227,3 +231,93 @@ TEST(LaplaceTest, mass_matrix_on_quads)
     auto mesh = quad_sphere();
     EXPECT_LT(mass_matrix_error(mesh), 1e-3);
 }
+
+TEST(LaplaceTest, laplace_operator)
+{
+    auto mesh = open_cone();
+    DenseMatrix X, Y;
+    coordinates_to_matrix(mesh, X);
+
+    for (bool uniform : {false, true})
+    {
+        for (bool clamp : {false, true})
+        {
+            if (uniform && clamp)
+                continue;
+
+            SparseMatrix L;
+            if (uniform)
+                uniform_laplace_matrix(mesh, L);
+            else
+                laplace_matrix(mesh, L, clamp);
+
+            const LaplaceOperator op(mesh, uniform, clamp);
+            op.multiply(X, Y);
+            EXPECT_LT((Y - L * X).norm(), 1e-10);
+            EXPECT_LT((op.diagonal() - Eigen::VectorXd(L.diagonal())).norm(),
+                      1e-10);
+        }
+    }
+
+    // cotan weights require triangles
+    auto quad_mesh = quad_sphere();
+    EXPECT_THROW(LaplaceOperator{quad_mesh}, InvalidInputException);
+    EXPECT_NO_THROW(LaplaceOperator(quad_mesh, true));
+}
+
+TEST(LaplaceTest, matrix_structure)
+{
+    auto quad_mesh = plane(4);
+    auto tri_mesh = quad_mesh;
+    triangulate(tri_mesh);
+
+    for (const auto& mesh : {tri_mesh, quad_mesh})
+    {
+        SparseMatrix L;
+        laplace_matrix(mesh, L);
+        EXPECT_LT((L - SparseMatrix(L.transpose())).norm(), 1e-12);
+        EXPECT_LT((L * Eigen::VectorXd::Ones(L.cols())).norm(), 1e-12);
+
+        // one entry per vertex of the incident faces
+        for (auto v : mesh.vertices())
+        {
+            std::set<int> pattern;
+            for (auto f : mesh.faces(v))
+                for (auto vv : mesh.vertices(f))
+                    pattern.insert(vv.idx());
+            EXPECT_EQ(L.col(v.idx()).nonZeros(), Eigen::Index(pattern.size()));
+        }
+
+        // columns of the divergence are scaled rows of the gradient
+        SparseMatrix G, D;
+        gradient_matrix(mesh, G);
+        divergence_matrix(mesh, D);
+        EXPECT_EQ(D.nonZeros(), G.nonZeros());
+        EXPECT_LT((L - D * G).norm(), 1e-12);
+    }
+}
+
+TEST(LaplaceTest, polygon_sizes)
+{
+    // small polygons use fixed-size operators, larger ones dynamic ones
+    for (size_t n = 3; n <= 8; ++n)
+    {
+        auto mesh = cone(n);
+        EXPECT_LT(div_grad_error(mesh), 1e-12);
+        EXPECT_LT(mass_matrix_error(mesh), 1e-3);
+
+        // irregular planar polygon
+        SurfaceMesh polygon;
+        std::vector<Vertex> vertices;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Scalar angle = 2.0 * std::numbers::pi * i / n;
+            const Scalar radius = 1.0 + 0.1 * (i % 2);
+            vertices.push_back(polygon.add_vertex(
+                Point(radius * std::cos(angle), radius * std::sin(angle), 0)));
+        }
+        polygon.add_face(vertices);
+        EXPECT_LT(constant_gradient_error(polygon), 1e-12);
+        EXPECT_LT(mass_matrix_error(polygon), 1e-6);
+    }
+}
@@ -0,0 +1,77 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/differential_geometry.h"
+#include "pmp/algorithms/fairing.h"
+#include "pmp/algorithms/laplace.h"
+#include "pmp/algorithms/multigrid.h"
+#include "pmp/algorithms/shapes.h"
+#include "pmp/algorithms/smoothing.h"
+#include "pmp/algorithms/subdivision.h"
+#include "pmp/exceptions.h"
+#include "helpers.h"
+
+using namespace pmp;
+
+TEST(MultigridTest, multigrid_solver)
+{
+    auto mesh = icosphere(4);
+    SparseMatrix L;
+    DiagonalMatrix M;
+    laplace_matrix(mesh, L);
+    mass_matrix(mesh, M);
+    const SparseMatrix A = SparseMatrix(M) - 0.1 * L;
+
+    DenseMatrix B;
+    coordinates_to_matrix(mesh, B);
+
+    MultigridSolver solver(mesh, 100);
+    EXPECT_GT(solver.n_levels(), 2u);
+
+    // unconstrained
+    solver.compute(A);
+    DenseMatrix X = DenseMatrix::Zero(B.rows(), B.cols());
+    solver.solve(B, X, 1e-10);
+    EXPECT_LT((X - cholesky_solve(A, B)).norm(), 1e-6);
+
+    // constrained, constrained entries keep their values
+    auto is_constrained = [](unsigned int i) { return i < 10; };
+    solver.compute(A, is_constrained);
+    X = B;
+    solver.solve(B, X, 1e-10);
+    EXPECT_LT((X - cholesky_solve(A, B, is_constrained, B)).norm(), 1e-6);
+    EXPECT_EQ(X.topRows(10), B.topRows(10));
+
+    // wrong dimensions and non-triangle meshes
+    EXPECT_THROW(solver.compute(SparseMatrix(3, 3)), InvalidInputException);
+    EXPECT_THROW(MultigridSolver{quad_sphere(2)}, InvalidInputException);
+}
+
+TEST(MultigridTest, fairing_with_multigrid)
+{
+    for (unsigned int k : {1, 2})
+    {
+        auto mesh = open_cone();
+        for (int i = 0; i < 5; ++i)
+            loop_subdivision(mesh);
+        auto reference = mesh;
+        fair(reference, k);
+        fair(mesh, k, LinearSolver::Multigrid);
+        for (auto v : mesh.vertices())
+            EXPECT_LT(distance(mesh.position(v), reference.position(v)), 1e-4);
+    }
+}
+
+TEST(MultigridTest, implicit_smoothing_with_multigrid)
+{
+    auto mesh = open_cone();
+    for (int i = 0; i < 5; ++i)
+        loop_subdivision(mesh);
+    auto reference = mesh;
+    implicit_smoothing(reference, 0.01, 2);
+    implicit_smoothing(mesh, 0.01, 2, false, true, LinearSolver::Multigrid);
+    for (auto v : mesh.vertices())
+        EXPECT_LT(distance(mesh.position(v), reference.position(v)), 1e-5);
+}
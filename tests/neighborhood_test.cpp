@@ -0,0 +1,79 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/neighborhood.h"
+#include "pmp/algorithms/shapes.h"
+#include "pmp/exceptions.h"
+#include "helpers.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace pmp;
+
+TEST(NeighborhoodTest, one_ring)
+{
+    auto mesh = open_cone();
+    const NeighborhoodIndex index(mesh);
+    EXPECT_EQ(index.k(), 1u);
+    for (auto v : mesh.vertices())
+    {
+        std::vector<Vertex> one_ring;
+        for (auto vv : mesh.vertices(v))
+            one_ring.push_back(vv);
+        EXPECT_TRUE(std::ranges::equal(index.neighbors(v), one_ring));
+    }
+}
+
+TEST(NeighborhoodTest, two_ring)
+{
+    auto mesh = icosphere(2);
+    const NeighborhoodIndex index(mesh, 2);
+    for (auto v : mesh.vertices())
+    {
+        // two-ring by brute force
+        std::set<Vertex> two_ring;
+        for (auto vv : mesh.vertices(v))
+            for (auto vvv : mesh.vertices(vv))
+                two_ring.insert(vvv);
+        for (auto vv : mesh.vertices(v))
+            two_ring.insert(vv);
+        two_ring.erase(v);
+
+        const auto neighbors = index.neighbors(v);
+        EXPECT_EQ(neighbors.size(), two_ring.size());
+        EXPECT_TRUE(std::ranges::equal(std::set(neighbors.begin(),
+                                                neighbors.end()),
+                                       two_ring));
+
+        // sorted by ring
+        std::set<Vertex> one_ring;
+        for (auto vv : mesh.vertices(v))
+            one_ring.insert(vv);
+        const auto first = neighbors.first(one_ring.size());
+        EXPECT_TRUE(std::ranges::equal(std::set(first.begin(), first.end()),
+                                       one_ring));
+    }
+}
+
+TEST(NeighborhoodTest, update)
+{
+    auto mesh = icosphere(1);
+    NeighborhoodIndex index(mesh, 3);
+    mesh.split(*mesh.edges().begin(), Point(0, 0, 0));
+    index.update(mesh);
+
+    const NeighborhoodIndex rebuilt(mesh, 3);
+    EXPECT_EQ(index.n_neighbors(), rebuilt.n_neighbors());
+    for (auto v : mesh.vertices())
+        EXPECT_TRUE(
+            std::ranges::equal(index.neighbors(v), rebuilt.neighbors(v)));
+}
+
+TEST(NeighborhoodTest, zero_rings)
+{
+    auto mesh = icosphere(1);
+    EXPECT_THROW(NeighborhoodIndex(mesh, 0), InvalidInputException);
+}
@@ -3,7 +3,10 @@
 
 #include "gtest/gtest.h"
 
+#include "pmp/algorithms/laplace.h"
 #include "pmp/algorithms/numerics.h"
+#include "pmp/algorithms/shapes.h"
+#include "pmp/exceptions.h"
 #include "pmp/io/io.h"
 
 using namespace pmp;
@@ -36,3 +39,185 @@ TEST(NumericsTest, mesh_to_matrices)
     EXPECT_TRUE(F.cols() == 3);
     EXPECT_TRUE(F.rows() == 1);
 }
+
+TEST(NumericsTest, sparse_solver_cache)
+{
+    auto mesh = icosphere(2);
+    SparseMatrix L;
+    DiagonalMatrix M;
+    laplace_matrix(mesh, L);
+    mass_matrix(mesh, M);
+
+    DenseMatrix B;
+    coordinates_to_matrix(mesh, B);
+
+    // same pattern, different coefficients: analyze only once
+    SparseSolverCache solver;
+    for (double t : {0.1, 0.01, 0.001})
+    {
+        const SparseMatrix A = SparseMatrix(M) - t * L;
+        const DenseMatrix X = solver.solve(A, B);
+        EXPECT_LT((X - cholesky_solve(A, B)).norm(), 1e-10);
+        EXPECT_LT((A * X - B).norm(), 1e-8);
+    }
+    EXPECT_EQ(solver.n_analyses(), 1u);
+
+    // different pattern
+    const SparseMatrix A = SparseMatrix(M) - 0.1 * L + L * L;
+    EXPECT_LT((A * solver.solve(A, B) - B).norm(), 1e-8);
+    EXPECT_EQ(solver.n_analyses(), 2u);
+}
+
+TEST(NumericsTest, sparse_solver_cache_single_precision)
+{
+    auto mesh = icosphere(3);
+    SparseMatrix L;
+    DiagonalMatrix M;
+    laplace_matrix(mesh, L);
+    mass_matrix(mesh, M);
+
+    DenseMatrix B;
+    coordinates_to_matrix(mesh, B);
+    B = M * B;
+
+    // refinement recovers double precision accuracy
+    SparseSolverCache solver(FactorizationPrecision::Single);
+    for (double t : {0.1, 0.01})
+    {
+        const SparseMatrix A = SparseMatrix(M) - t * L;
+        const DenseMatrix X = solver.solve(A, B);
+        EXPECT_LT((A * X - B).norm(), 1e-10 * B.norm());
+        EXPECT_LT((X - cholesky_solve(A, B)).norm(), 1e-8);
+    }
+    EXPECT_EQ(solver.n_analyses(), 1u);
+
+    // constrained solves
+    auto is_constrained = [](unsigned int i) { return i % 4 == 0; };
+    ConstrainedSolver constrained(mesh.n_vertices(), is_constrained,
+                                  FactorizationPrecision::Single);
+    const SparseMatrix A = SparseMatrix(M) - 0.1 * L;
+    const DenseMatrix X = constrained.solve(A, B, B);
+    EXPECT_LT((X - cholesky_solve(A, B, is_constrained, B)).norm(), 1e-8);
+}
+
+TEST(NumericsTest, constrained_solver)
+{
+    auto mesh = icosphere(2);
+    SparseMatrix L;
+    DiagonalMatrix M;
+    laplace_matrix(mesh, L);
+    mass_matrix(mesh, M);
+
+    DenseMatrix B, C;
+    coordinates_to_matrix(mesh, B);
+    C = 2.0 * B;
+
+    auto is_constrained = [](unsigned int i) { return i % 4 == 0; };
+    ConstrainedSolver solver(mesh.n_vertices(), is_constrained);
+    EXPECT_EQ(solver.n_dofs(), mesh.n_vertices() - 41);
+
+    // same pattern, different coefficients: analyze only once
+    for (double t : {0.1, 0.01, 0.001})
+    {
+        const SparseMatrix A = SparseMatrix(M) - t * L;
+        const DenseMatrix X = solver.solve(A, B, C);
+
+        // dense reference with identity rows for constrained entries
+        DenseMatrix Ad = A, Bd = B;
+        for (unsigned int i = 0; i < mesh.n_vertices(); ++i)
+        {
+            if (is_constrained(i))
+            {
+                Ad.row(i).setZero();
+                Ad(i, i) = 1.0;
+                Bd.row(i) = C.row(i);
+            }
+        }
+        EXPECT_LT((X - Ad.partialPivLu().solve(Bd)).norm(), 1e-10);
+        EXPECT_LT((X - cholesky_solve(A, B, is_constrained, C)).norm(), 1e-10);
+    }
+    EXPECT_EQ(solver.n_analyses(), 1u);
+    EXPECT_EQ(solver.n_factorizations(), 3u);
+
+    // unchanged coefficients reuse the factorization
+    solver.factorize(SparseMatrix(M) - 0.001 * L);
+    EXPECT_EQ(solver.n_factorizations(), 3u);
+
+    // new right hand sides reuse the factorization
+    const SparseMatrix A = SparseMatrix(M) - 0.001 * L;
+    const DenseMatrix X = solver.solve(2.0 * B, C);
+    EXPECT_LT((X - cholesky_solve(A, 2.0 * B, is_constrained, C)).norm(),
+              1e-10);
+
+    // wrong dimensions
+    EXPECT_THROW(solver.factorize(SparseMatrix(3, 3)), InvalidInputException);
+    EXPECT_THROW(solver.solve(B.topRows(3), C), InvalidInputException);
+}
+
+TEST(NumericsTest, cholesky_solve_errors)
+{
+    // explicitly stored zero diagonal
+    SparseMatrix A(3, 3);
+    std::vector<Triplet> triplets{{0, 0, 0.0}, {1, 1, 0.0}, {2, 2, 0.0}};
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    const DenseMatrix B = DenseMatrix::Ones(3, 1);
+
+    auto expect_message = [](auto&& solve) {
+        try
+        {
+            solve();
+            FAIL() << "Expected SolverException";
+        }
+        catch (const SolverException& e)
+        {
+            EXPECT_EQ(std::string(e.what()).rfind("cholesky_solve: ", 0), 0u)
+                << e.what();
+        }
+    };
+    expect_message([&] { cholesky_solve(A, B); });
+    auto is_constrained = [](unsigned int i) { return i == 0; };
+    expect_message([&] { cholesky_solve(A, B, is_constrained, B); });
+}
+
+TEST(NumericsTest, conjugate_gradient_solve)
+{
+    auto mesh = icosphere(2);
+    SparseMatrix L;
+    DiagonalMatrix M;
+    laplace_matrix(mesh, L);
+    mass_matrix(mesh, M);
+    const SparseMatrix A = SparseMatrix(M) - 0.1 * L;
+    auto op = [&](const DenseMatrix& x, DenseMatrix& y) { y = A * x; };
+
+    DenseMatrix B;
+    coordinates_to_matrix(mesh, B);
+
+    // unconstrained, with and without preconditioner
+    for (const Eigen::VectorXd& diagonal :
+         {Eigen::VectorXd(A.diagonal()), Eigen::VectorXd()})
+    {
+        DenseMatrix X = DenseMatrix::Zero(B.rows(), B.cols());
+        conjugate_gradient_solve(op, diagonal, B, X);
+        EXPECT_LT((X - cholesky_solve(A, B)).norm(), 1e-6);
+    }
+
+    // constrained, constrained entries keep their values
+    auto is_constrained = [](unsigned int i) { return i < 10; };
+    DenseMatrix X = B;
+    conjugate_gradient_solve(op, A.diagonal(), B, X, is_constrained);
+    EXPECT_LT((X - cholesky_solve(A, B, is_constrained, B)).norm(), 1e-6);
+    EXPECT_EQ(X.topRows(10), B.topRows(10));
+
+    // warm start from the solution needs no iterations
+    EXPECT_EQ(conjugate_gradient_solve(op, A.diagonal(), B, X, is_constrained,
+                                       1e-6),
+              0u);
+
+    // non-convergence and wrong dimensions
+    X.setZero();
+    EXPECT_THROW(conjugate_gradient_solve(op, A.diagonal(), B, X, {}, 1e-8, 1),
+                 SolverException);
+    X.resize(1, 3);
+    EXPECT_THROW(conjugate_gradient_solve(op, A.diagonal(), B, X),
+                 InvalidInputException);
+}
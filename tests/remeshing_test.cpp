@@ -54,9 +54,63 @@ TEST(RemeshingTest, adaptive_remeshing_with_selection)
     EXPECT_EQ(mesh.n_vertices(), size_t(62));
 }
 
+TEST(RemeshingTest, adaptive_remeshing_with_sizing_field)
+{
+    auto mesh = open_cone();
+    auto bb = bounds(mesh).size();
+    const SizingField sizing_field(mesh);
+
+    // same result as analyzing the input mesh itself
+    auto mesh1 = mesh;
+    adaptive_remeshing(mesh1, sizing_field, 0.01 * bb, 1.0 * bb, 0.01 * bb);
+    EXPECT_EQ(mesh1.n_vertices(), size_t(104));
+
+    // reuse for a coarser approximation
+    auto mesh2 = mesh;
+    adaptive_remeshing(mesh2, sizing_field, 0.01 * bb, 1.0 * bb, 0.05 * bb);
+    EXPECT_LT(mesh2.n_vertices(), mesh1.n_vertices());
+
+    // edge lengths are clamped, up to interpolation round-off
+    const Scalar min_length = 0.01 * bb;
+    const Scalar max_length = 0.1 * bb;
+    for (auto v : mesh.vertices())
+    {
+        const auto h = sizing_field.edge_length(mesh.position(v), min_length,
+                                                max_length, 0.01 * bb);
+        EXPECT_GE(h, 0.99 * min_length);
+        EXPECT_LE(h, 1.01 * max_length);
+    }
+}
+
 TEST(RemeshingTest, uniform_remeshing)
 {
     auto mesh = open_cone();
     uniform_remeshing(mesh, 0.5);
     EXPECT_EQ(mesh.n_vertices(), size_t(41));
 }
+
+TEST(RemeshingTest, uniform_remeshing_with_selection)
+{
+    auto mesh = icosphere(3);
+
+    // select a small cap
+    auto selected = mesh.add_vertex_property<bool>("v:selected");
+    std::vector<Point> unselected;
+    for (auto v : mesh.vertices())
+    {
+        if (mesh.position(v)[1] > 0.8)
+            selected[v] = true;
+        else
+            unselected.push_back(mesh.position(v));
+    }
+
+    uniform_remeshing(mesh, 0.05);
+
+    // the cap got refined, all other vertices are unchanged
+    EXPECT_GT(mesh.n_vertices(), size_t(642));
+    size_t n_unchanged = 0;
+    for (auto v : mesh.vertices())
+        if (std::ranges::find(unselected, mesh.position(v)) != unselected.end())
+            ++n_unchanged;
+    EXPECT_EQ(n_unchanged, unselected.size());
+}
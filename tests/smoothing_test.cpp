@@ -5,6 +5,8 @@
 
 #include "pmp/algorithms/smoothing.h"
 #include "pmp/algorithms/differential_geometry.h"
+#include "pmp/algorithms/subdivision.h"
+#include "pmp/exceptions.h"
 #include "helpers.h"
 
 using namespace pmp;
@@ -27,6 +29,60 @@ TEST(SmoothingTest, implicit_smoothing_with_rescale)
     EXPECT_FLOAT_EQ(area_after, area_before);
 }
 
+TEST(SmoothingTest, implicit_smoothing_with_conjugate_gradients)
+{
+    for (bool uniform : {false, true})
+    {
+        auto mesh = open_cone();
+        auto reference = mesh;
+        implicit_smoothing(reference, 0.01, 2, uniform, true);
+        implicit_smoothing(mesh, 0.01, 2, uniform, true,
+                           LinearSolver::ConjugateGradient);
+        for (auto v : mesh.vertices())
+            EXPECT_LT(distance(mesh.position(v), reference.position(v)), 1e-5);
+    }
+}
+
+TEST(SmoothingTest, implicit_smoothing_with_mixed_precision)
+{
+    auto mesh = open_cone();
+    auto reference = mesh;
+    implicit_smoothing(reference, 0.01, 2, false, true);
+    implicit_smoothing(mesh, 0.01, 2, false, true,
+                       LinearSolver::MixedPrecision);
+    for (auto v : mesh.vertices())
+        EXPECT_LT(distance(mesh.position(v), reference.position(v)), 1e-6);
+}
+
+TEST(SmoothingTest, implicit_smoothing_frames)
+{
+    for (bool uniform : {false, true})
+    {
+        auto mesh = open_cone();
+
+        // scaled and translated copies of the mesh
+        std::vector<std::vector<Point>> frames;
+        std::vector<SurfaceMesh> references;
+        for (int i = 0; i < 20; ++i)
+        {
+            auto frame = mesh;
+            for (auto v : frame.vertices())
+                frame.position(v) = (1.0f + 0.1f * i) * frame.position(v) +
+                                    Point(i, 0, 0);
+            frames.push_back(frame.positions());
+            implicit_smoothing(frame, 0.01, 2, uniform, true);
+            references.push_back(frame);
+        }
+
+        implicit_smoothing(mesh, frames, 0.01, 2, uniform, true);
+        for (size_t i = 0; i < frames.size(); ++i)
+            for (auto v : mesh.vertices())
+                EXPECT_LT(distance(frames[i][v.idx()],
+                                   references[i].position(v)),
+                          1e-5);
+    }
+}
+
 TEST(SmoothingTest, explicit_smoothing)
 {
     auto mesh = open_cone();
@@ -36,3 +92,49 @@ TEST(SmoothingTest, explicit_smoothing)
     auto area_after = surface_area(mesh);
     EXPECT_LT(area_after, area_before);
 }
+
+TEST(SmoothingTest, explicit_smoother)
+{
+    auto mesh = open_cone();
+    loop_subdivision(mesh);
+    auto reference = mesh;
+    explicit_smoothing(reference, 10, false);
+
+    // smooth() is explicit_smoothing()
+    ExplicitSmoother smoother(mesh);
+    smoother.smooth(10);
+    auto laplacian = mesh;
+    smoother.write(laplacian);
+    for (auto v : mesh.vertices())
+        EXPECT_LT(distance(laplacian.position(v), reference.position(v)),
+                  1e-5);
+
+    // Taubin and HC smoothing shrink less than Laplacian smoothing
+    auto taubin = mesh;
+    smoother.read(mesh);
+    smoother.taubin_smooth(10);
+    smoother.write(taubin);
+
+    auto hc = mesh;
+    smoother.read(mesh);
+    smoother.hc_smooth(10);
+    smoother.write(hc);
+
+    const auto area = surface_area(mesh);
+    EXPECT_LT(surface_area(laplacian), surface_area(taubin));
+    EXPECT_LT(surface_area(laplacian), surface_area(hc));
+    EXPECT_LT(surface_area(taubin), area);
+    EXPECT_LT(surface_area(hc), area);
+
+    // boundary vertices are fixed
+    for (auto v : mesh.vertices())
+    {
+        if (mesh.is_boundary(v))
+        {
+            EXPECT_EQ(taubin.position(v), mesh.position(v));
+            EXPECT_EQ(hc.position(v), mesh.position(v));
+        }
+    }
+
+    EXPECT_THROW(smoother.read(vertex_onering()), InvalidInputException);
+}
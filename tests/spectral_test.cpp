@@ -0,0 +1,140 @@
+// Copyright 2026 the Polygon Mesh Processing Library developers.
+// SPDX-License-Identifier: MIT
+
+#include "gtest/gtest.h"
+
+#include "pmp/algorithms/laplace.h"
+#include "pmp/algorithms/shapes.h"
+#include "pmp/algorithms/spectral.h"
+#include "pmp/algorithms/subdivision.h"
+#include "pmp/exceptions.h"
+#include "helpers.h"
+
+using namespace pmp;
+
+namespace {
+
+// check -L Phi = M Phi Lambda and Phi^T M Phi = I
+void check_eigenpairs(const SurfaceMesh& mesh, const LaplaceEigenbasis& basis)
+{
+    SparseMatrix L;
+    laplace_matrix(mesh, L);
+    const DenseMatrix& Phi = basis.eigenvectors;
+    const DenseMatrix residual = -L * Phi - basis.mass * Phi *
+                                               basis.eigenvalues.asDiagonal();
+    const DenseMatrix MPhi = basis.mass * Phi;
+    EXPECT_LT(residual.norm(),
+              1e-6 * (MPhi * basis.eigenvalues.asDiagonal()).norm());
+    const auto k = Phi.cols();
+    EXPECT_LT((Phi.transpose() * MPhi - DenseMatrix::Identity(k, k)).norm(),
+              1e-8);
+    for (Eigen::Index i = 1; i < k; ++i)
+        EXPECT_LE(basis.eigenvalues[i - 1], basis.eigenvalues[i] + 1e-10);
+}
+
+} // namespace
+
+TEST(SpectralTest, laplace_eigenbasis_sphere)
+{
+    // eigenvalues l(l+1) with multiplicity 2l+1 on the unit sphere
+    auto mesh = icosphere(4);
+    const auto basis = laplace_eigenbasis(mesh, 16);
+    check_eigenpairs(mesh, basis);
+
+    EXPECT_NEAR(basis.eigenvalues[0], 0.0, 1e-8);
+    for (int i = 1; i < 4; ++i)
+        EXPECT_NEAR(basis.eigenvalues[i], 2.0, 0.01);
+    for (int i = 4; i < 9; ++i)
+        EXPECT_NEAR(basis.eigenvalues[i], 6.0, 0.05);
+    for (int i = 9; i < 16; ++i)
+        EXPECT_NEAR(basis.eigenvalues[i], 12.0, 0.1);
+}
+
+TEST(SpectralTest, laplace_eigenbasis_open_mesh)
+{
+    // compare Lanczos iterations with a dense eigendecomposition
+    auto mesh = open_cone();
+    for (int i = 0; i < 3; ++i)
+        loop_subdivision(mesh);
+    ASSERT_GT(mesh.n_vertices(), 100u);
+    const auto basis = laplace_eigenbasis(mesh, 10);
+    check_eigenpairs(mesh, basis);
+
+    const auto all = laplace_eigenbasis(mesh, mesh.n_vertices());
+    check_eigenpairs(mesh, all);
+    EXPECT_LT((all.eigenvalues.head(10) - basis.eigenvalues).norm(), 1e-8);
+}
+
+TEST(SpectralTest, laplace_eigenbasis_invalid_input)
+{
+    auto mesh = icosphere(1);
+    EXPECT_THROW(laplace_eigenbasis(mesh, 0), InvalidInputException);
+    EXPECT_THROW(laplace_eigenbasis(mesh, mesh.n_vertices() + 1),
+                 InvalidInputException);
+}
+
+TEST(SpectralTest, spectral_smoothing)
+{
+    auto mesh = icosphere(2);
+    const auto basis = laplace_eigenbasis(mesh, mesh.n_vertices());
+
+    // the full basis reproduces the mesh
+    auto copy = mesh;
+    spectral_smoothing(copy, basis, [](double) { return 1.0; });
+    for (auto v : mesh.vertices())
+        EXPECT_LT(distance(copy.position(v), mesh.position(v)), 1e-5);
+
+    // low-pass filter of a noisy sphere
+    for (auto v : mesh.vertices())
+        mesh.position(v) *= 1.0f + 0.05f * ((v.idx() % 3) - 1.0f);
+    spectral_smoothing(mesh, basis,
+                       [](double lambda) { return lambda < 7.0 ? 1.0 : 0.0; });
+    for (auto v : mesh.vertices())
+        EXPECT_NEAR(norm(mesh.position(v)), 1.0, 0.03);
+}
+
+TEST(SpectralTest, spectral_compression)
+{
+    auto mesh = icosphere(2);
+    const auto basis = laplace_eigenbasis(mesh, 64);
+
+    // the error decreases with the number of coefficients
+    auto decompressed = mesh;
+    double previous_error = std::numeric_limits<double>::max();
+    for (unsigned int k : {1, 4, 16, 64})
+    {
+        const DenseMatrix C = spectral_compress(mesh, basis, k);
+        EXPECT_EQ(C.rows(), k);
+        spectral_decompress(decompressed, basis, C);
+        double error = 0.0;
+        for (auto v : mesh.vertices())
+            error += sqrnorm(decompressed.position(v) - mesh.position(v));
+        EXPECT_LT(error, previous_error);
+        previous_error = error;
+    }
+
+    EXPECT_THROW(spectral_compress(mesh, basis, 65), InvalidInputException);
+    EXPECT_THROW(spectral_compress(icosphere(1), basis, 4),
+                 InvalidInputException);
+}
+
+TEST(SpectralTest, eigenbasis_cache)
+{
+    auto mesh = icosphere(3);
+    LaplaceEigenbasisCache cache;
+    cache.basis(mesh, 10);
+    EXPECT_EQ(cache.n_computations(), 1u);
+
+    // same connectivity: reuse
+    for (auto v : mesh.vertices())
+        mesh.position(v) *= 2.0f;
+    const auto& basis = cache.basis(mesh, 10);
+    EXPECT_EQ(cache.n_computations(), 1u);
+    spectral_smoothing(mesh, basis, [](double) { return 1.0; });
+
+    // different number of eigenpairs or connectivity
+    cache.basis(mesh, 20);
+    EXPECT_EQ(cache.n_computations(), 2u);
+    cache.basis(icosphere(2), 20);
+    EXPECT_EQ(cache.n_computations(), 3u);
+}